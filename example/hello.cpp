@@ -14,7 +14,8 @@
 #include <vector>
 #include <regex>
 #include <functional>
-#include <iostream>
+
+#include <unistd.h>
 
 #include <boost/algorithm/string/trim.hpp>
 
@@ -59,21 +60,15 @@ int main()
   auto grep_error = std::bind(grep, "Error.*", _1, _2);
 
   boost::pipeline::thread_pool pool;
-  std::vector<std::string> output;
 
   auto execution =
   (boost::pipeline::from(input)
     | trim
     | grep_error
     | [] (const std::string& input) { return "-> " + input; }
-    | output
+    | boost::pipeline::to_fd(STDOUT_FILENO)
   ).run(pool);
   //]
 
   execution.wait();
-
-  for (auto& out_item : output)
-  {
-    std::cout << out_item << std::endl;
-  }
 }
@@ -13,7 +13,6 @@
 #include <string>
 #include <vector>
 #include <iostream>
-#include <functional>
 
 #include <boost/pipeline.hpp>
 namespace ppl = boost::pipeline;
@@ -37,36 +36,19 @@ struct relation
 };
 
 //[example_join_joiner
-void join(
-  ppl::queue_front<department> deps,
-  ppl::queue_front<person> perss,
-  ppl::queue_back<relation> downstream
-)
+int department_id(const department& dep)
 {
-  department dep;
-  person pers{"", -1};
+  return dep.id;
+}
 
-  while (deps.wait_pull(dep))
-  {
-    if (dep.id == pers.department_id)
-    {
-      relation rel{dep.name, pers.name};
-      downstream.push(std::move(rel));
-    }
-
-    while (perss.wait_pull(pers))
-    {
-      if (dep.id == pers.department_id)
-      {
-        relation rel{dep.name, pers.name};
-        downstream.push(std::move(rel));
-      }
-      else
-      {
-        break;
-      }
-    }
-  }
+int person_department_id(const person& pers)
+{
+  return pers.department_id;
+}
+
+relation make_relation(const department& dep, const person& pers)
+{
+  return relation{dep.name, pers.name};
 }
 //]
 
@@ -115,8 +97,6 @@ void init_persons(ppl::queue<person>& queue)
 
 int main()
 {
-  using std::placeholders::_1;
-
   ppl::queue<department> departments;
   ppl::queue<person> persons;
 
@@ -127,11 +107,16 @@ int main()
   persons.close();
 
   //[example_join_invocation
-  auto relations = std::bind(join, std::ref(departments), std::ref(persons), _1);
-  auto plan = ppl::from<relation>(relations) | to_stdout;
+  auto relations = ppl::merge_join(
+    ppl::from(departments),
+    department_id, person_department_id,
+    make_relation
+  );
+
+  auto plan = ppl::from(persons) | relations | to_stdout;
   //]
 
-  ppl::thread_pool pool{2};
+  ppl::thread_pool pool{3};
   auto exec = plan.run(pool);
 
   exec.wait();
@@ -12,8 +12,9 @@
 
 #include <string>
 #include <sstream>
-#include <iostream>
-#include <functional>
+#include <cstddef>
+
+#include <unistd.h>
 
 #define BOOST_SPIRIT_THREADSAFE
 #include <boost/property_tree/ptree.hpp>
@@ -54,20 +55,9 @@ void generate_requests(ppl::queue_back<request>& downstream)
 }
 
 //[example_split_splitter
-void split_by_priority(
-  ppl::queue_back<request> priority,
-  ppl::queue_back<request> non_priority,
-  const request& input
-)
+std::size_t by_priority(const request& input)
 {
-  if (input.is_priority)
-  {
-    priority.push(input);
-  }
-  else
-  {
-    non_priority.push(input);
-  }
+  return (input.is_priority) ? 0 : 1;
 }
 //]
 
@@ -104,47 +94,30 @@ response request_id(const parsed_request& input)
   return output;
 }
 
-void to_stdout(const response& input)
+void format_response(const response& input, std::string& buffer)
 {
-  std::cout << input.body << std::endl;
+  buffer.append(input.body);
+  buffer.push_back('\n');
 }
 
 void process_later(const response&) { /* do nothing */ }
 
 int main()
 {
-  using std::placeholders::_1;
-
   //[example_split_invocation
-  ppl::queue<request> priority_queue;
-  ppl::queue<request> non_priority_queue;
-
-  auto split = std::bind(
-    split_by_priority,
-    std::ref(priority_queue),
-    std::ref(non_priority_queue),
-    _1
-  );
+  auto to_stdout = ppl::to_fd(STDOUT_FILENO, format_response);
 
-  auto reader = ppl::from(generate_requests) | split;
+  auto priority_processor = ppl::make(parse_request) | request_id | to_stdout;
+  auto processor          = ppl::make(parse_request) | request_id | process_later;
 
-  auto priority_processor = priority_queue | parse_request | request_id | to_stdout;
-  auto processor      = non_priority_queue | parse_request | request_id | process_later;
+  auto plan = ppl::from(generate_requests)
+    | ppl::route(by_priority, priority_processor, processor);
   //]
 
   ppl::thread_pool pool{8};
 
-  auto exec1 = reader.run(pool);
-  auto exec2 = priority_processor.run(pool);
-  auto exec3 = processor.run(pool);
-
-  exec1.wait();
-
-  priority_queue.close();
-  non_priority_queue.close();
-
-  exec2.wait();
-  exec3.wait();
+  auto exec = plan.run(pool);
+  exec.wait();
 
   return 0;
 }
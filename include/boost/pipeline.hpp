@@ -17,5 +17,24 @@
 #include <boost/pipeline/queue.hpp>
 #include <boost/pipeline/threading.hpp>
 #include <boost/pipeline/type_erasure.hpp>
+#include <boost/pipeline/batch.hpp>
+#include <boost/pipeline/window.hpp>
+#include <boost/pipeline/join.hpp>
+#include <boost/pipeline/fan_out.hpp>
+#include <boost/pipeline/fan_in.hpp>
+#include <boost/pipeline/reduce.hpp>
+#include <boost/pipeline/sort.hpp>
+#include <boost/pipeline/dedupe.hpp>
+#include <boost/pipeline/sketch.hpp>
+#include <boost/pipeline/reorder.hpp>
+#include <boost/pipeline/scan.hpp>
+#include <boost/pipeline/take.hpp>
+#include <boost/pipeline/cache.hpp>
+#include <boost/pipeline/async.hpp>
+#include <boost/pipeline/enrich.hpp>
+#include <boost/pipeline/shed.hpp>
+#include <boost/pipeline/conflate.hpp>
+#include <boost/pipeline/priority.hpp>
+#include <boost/pipeline/file.hpp>
 
 #endif // BOOST_PIPELINE_HPP
@@ -0,0 +1,204 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_ASYNC_HPP
+#define BOOST_PIPELINE_ASYNC_HPP
+
+#include <deque>
+#include <chrono>
+#include <thread>
+#include <future>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+#include <boost/pipeline/queue.hpp>
+#include <boost/pipeline/detail/segment.hpp>
+#include <boost/pipeline/detail/whole_stream.hpp>
+
+namespace boost {
+namespace pipeline {
+
+namespace detail {
+
+template <typename Function>
+class async_map_stage
+{
+  template <typename Input>
+  using future_type = typename std::decay<
+    decltype(std::declval<const Function&>()(std::declval<const Input&>()))
+  >::type;
+
+  template <typename Input>
+  using result_type = typename std::decay<
+    decltype(std::declval<future_type<Input>&>().get())
+  >::type;
+
+public:
+  template <typename Plan>
+  using connect_type = n_m_segment<Plan, result_type<typename Plan::value_type>, void>;
+
+  async_map_stage(const Function& function, std::size_t max_in_flight, bool ordered)
+    :_function(function),
+     _max_in_flight(std::max<std::size_t>(1, max_in_flight)),
+     _ordered(ordered)
+  {}
+
+  template <typename T, typename R>
+  void operator()(queue_front<T>& upstream, queue_back<R>& downstream) const
+  {
+    typedef future_type<T> future;
+
+    const std::chrono::microseconds max_backoff(1000);
+    std::chrono::microseconds backoff(20);
+
+    // whole-stream stage, see pull_or_cancel
+    std::deque<future> in_flight;
+    bool has_input = true;
+
+    T item;
+    while (has_input || ! in_flight.empty())
+    {
+      if (downstream.is_cancelled())
+      {
+        // the pending results are discarded
+        upstream.cancel();
+        return;
+      }
+
+      bool progress = emit_ready(in_flight, downstream);
+
+      if (has_input && in_flight.size() < _max_in_flight)
+      {
+        if (in_flight.empty())
+        {
+          // nothing to wait for but the upstream
+          has_input = pull_or_cancel(upstream, downstream, item);
+          if (has_input) { in_flight.push_back(_function(item)); }
+          progress = true;
+        }
+        else if (upstream.try_pull(item))
+        {
+          in_flight.push_back(_function(item));
+          progress = true;
+        }
+        else if (upstream.is_closed() && upstream.is_empty())
+        {
+          has_input = false;
+          progress = true;
+        }
+      }
+
+      if (progress)
+      {
+        backoff = std::chrono::microseconds(20);
+      }
+      else
+      {
+        // wait for the upstream or the pending results
+        in_flight.front().wait_for(backoff);
+        backoff = std::min(backoff * 2, max_backoff);
+      }
+    }
+  }
+
+private:
+  template <typename Future>
+  static bool is_ready(Future& f)
+  {
+    return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+  }
+
+  /**
+   * The error of a failed operation is thrown by `get()`,
+   * the task running the stage reports it to `execution::wait()`.
+   *
+   * @returns true, if any result is emitted
+   */
+  template <typename Future, typename R>
+  bool emit_ready(std::deque<Future>& in_flight, queue_back<R>& downstream) const
+  {
+    bool emitted = false;
+
+    if (_ordered)
+    {
+      while (! in_flight.empty() && is_ready(in_flight.front()))
+      {
+        downstream.push(in_flight.front().get());
+        in_flight.pop_front();
+        emitted = true;
+      }
+    }
+    else
+    {
+      for (auto it = in_flight.begin(); it != in_flight.end();)
+      {
+        if (is_ready(*it))
+        {
+          downstream.push(it->get());
+          it = in_flight.erase(it);
+          emitted = true;
+        }
+        else
+        {
+          ++it;
+        }
+      }
+    }
+
+    return emitted;
+  }
+
+  Function _function;
+  std::size_t _max_in_flight;
+  bool _ordered;
+};
+
+} // namespace detail
+
+/**
+ * Creates a stage which starts an asynchronous operation
+ * for each item and emits the results as they complete.
+ *
+ * `function` must start the operation and return a future of its result,
+ * e.g: an `std::future` returned by a client library. Up to
+ * `max_in_flight` operations are pending at once, a single thread
+ * of the pool waits for all of them. If `ordered`, results are emitted
+ * in the order of the input items, otherwise in the order of completion.
+ * If the downstream is cancelled, no more operations are started
+ * and the results of the pending ones are discarded.
+ * If an operation fails, the upstream is cancelled, the pending results
+ * are discarded as well, and `execution::wait()` rethrows the error.
+ *
+ * @code
+ * auto lookup = [&](const std::string& key) { return client.async_get(key); };
+ * from(keys) | async_map(lookup, 64) | process
+ * @endcode
+ *
+ * @param function `F function(const T&)` where `F` is an `std::future<R>`
+ *                 or provides `R get()` and `std::future_status wait_for(duration)`
+ * @param max_in_flight Maximum number of pending operations, must be positive
+ * @param ordered If true, results keep the order of the input
+ * @returns A transformation of `T` items to `R` results
+ */
+template <typename Function>
+detail::async_map_stage<Function>
+async_map(Function function, std::size_t max_in_flight, bool ordered = true)
+{
+  return detail::async_map_stage<Function>(function, max_in_flight, ordered);
+}
+
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_ASYNC_HPP
@@ -0,0 +1,238 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_BATCH_HPP
+#define BOOST_PIPELINE_BATCH_HPP
+
+#include <vector>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+
+#include <boost/pipeline/queue.hpp>
+#include <boost/pipeline/detail/segment.hpp>
+
+namespace boost {
+namespace pipeline {
+
+namespace detail {
+
+class batch_stage
+{
+public:
+  typedef std::chrono::steady_clock clock;
+
+  template <typename Plan>
+  using connect_type = n_m_segment<
+    Plan, std::vector<typename Plan::value_type>, void
+  >;
+
+  batch_stage(std::size_t max_items, clock::duration max_delay)
+    :_max_items(max_items),
+     _max_delay(max_delay)
+  {}
+
+  template <typename T>
+  void operator()(queue_front<T>& upstream, queue_back<std::vector<T>>& downstream) const
+  {
+    T item;
+    if (! upstream.wait_pull(item)) { return; }
+
+    std::vector<T> items;
+    items.reserve(_max_items);
+    items.push_back(std::move(item));
+
+    if (_max_delay == clock::duration::max())
+    {
+      while (items.size() < _max_items && upstream.wait_pull(item))
+      {
+        items.push_back(std::move(item));
+      }
+    }
+    else
+    {
+      const auto deadline = clock::now() + _max_delay;
+
+      while (items.size() < _max_items && upstream.wait_pull_until(item, deadline))
+      {
+        items.push_back(std::move(item));
+      }
+    }
+
+    downstream.push(std::move(items));
+  }
+
+private:
+  std::size_t _max_items;
+  clock::duration _max_delay;
+};
+
+class adaptive_batch_stage
+{
+public:
+  template <typename Plan>
+  using connect_type = n_m_segment<
+    Plan, std::vector<typename Plan::value_type>, void
+  >;
+
+  explicit adaptive_batch_stage(std::size_t max_items)
+    :_max_items(max_items),
+     _batch_size(std::make_shared<std::atomic<std::size_t>>(1))
+  {}
+
+  template <typename T>
+  void operator()(queue_front<T>& upstream, queue_back<std::vector<T>>& downstream) const
+  {
+    T item;
+    if (! upstream.wait_pull(item)) { return; }
+
+    const std::size_t batch_size = *_batch_size;
+
+    std::vector<T> items;
+    items.reserve(batch_size);
+    items.push_back(std::move(item));
+
+    while (items.size() < batch_size && upstream.try_pull(item))
+    {
+      items.push_back(std::move(item));
+    }
+
+    // grow while the consumer is lagging behind,
+    // fall back to single items if there is nothing to wait for
+    if (downstream.size() > 0)
+    {
+      *_batch_size = std::min(batch_size * 2, _max_items);
+    }
+    else if (upstream.is_empty())
+    {
+      *_batch_size = 1;
+    }
+
+    downstream.push(std::move(items));
+  }
+
+  std::size_t batch_size() const
+  {
+    return *_batch_size;
+  }
+
+private:
+  std::size_t _max_items;
+  std::shared_ptr<std::atomic<std::size_t>> _batch_size; /**< shared among copies */
+};
+
+class unbatch_stage
+{
+public:
+  template <typename Plan>
+  using connect_type = one_n_segment<
+    Plan, typename Plan::value_type::value_type, void
+  >;
+
+  template <typename T>
+  void operator()(const std::vector<T>& items, queue_back<T>& downstream) const
+  {
+    for (const auto& item : items)
+    {
+      downstream.push(item);
+    }
+  }
+};
+
+} // namespace detail
+
+/**
+ * Creates a stage which groups items into `std::vector`s.
+ *
+ * A group is emitted if it reaches `max_items` items or
+ * `max_delay` is elapsed since its first item arrived,
+ * whichever comes first. The last group might be smaller
+ * if the upstream gets closed. Empty groups are never emitted.
+ *
+ * @code
+ * from(input) | batch(64, std::chrono::milliseconds(5)) | write_rows
+ * @endcode
+ *
+ * @param max_items Maximum number of items in a group, must be positive
+ * @param max_delay Maximum time to wait for a group to be filled up
+ * @returns A transformation of `T` items to `std::vector<T>` groups
+ */
+template <typename Rep, typename Period>
+detail::batch_stage
+batch(std::size_t max_items, const std::chrono::duration<Rep, Period>& max_delay)
+{
+  return detail::batch_stage(
+    max_items,
+    std::chrono::duration_cast<detail::batch_stage::clock::duration>(max_delay)
+  );
+}
+
+/**
+ * Creates a stage which groups every `max_items` items
+ * into an `std::vector`.
+ *
+ * Groups are emitted only if filled up or the upstream gets closed.
+ *
+ * @param max_items Maximum number of items in a group, must be positive
+ * @returns A transformation of `T` items to `std::vector<T>` groups
+ */
+inline detail::batch_stage batch(std::size_t max_items)
+{
+  return detail::batch_stage(
+    max_items,
+    detail::batch_stage::clock::duration::max()
+  );
+}
+
+/**
+ * Creates a stage which groups items into `std::vector`s
+ * of adaptive size.
+ *
+ * The group size is doubled (up to `max_items`) each time
+ * a group is emitted while the previous one is still not consumed
+ * by the downstream segment. It falls back to 1 if the upstream is idle.
+ * Groups are formed of already available items only, the stage never
+ * waits for a group to be filled up.
+ *
+ * The current group size is shared among the copies of the returned stage:
+ *
+ * @code
+ * auto batcher = adaptive_batch(1024);
+ * auto exec = (from(input) | batcher | write_rows).run(pool);
+ * std::size_t current = batcher.batch_size();
+ * @endcode
+ *
+ * @param max_items Maximum number of items in a group, must be positive
+ * @returns A transformation of `T` items to `std::vector<T>` groups
+ */
+inline detail::adaptive_batch_stage adaptive_batch(std::size_t max_items)
+{
+  return detail::adaptive_batch_stage(max_items);
+}
+
+/**
+ * Creates a stage which flattens `std::vector<T>` groups,
+ * e.g: produced by `batch()`, back into `T` items.
+ *
+ * @returns A transformation of `std::vector<T>` groups to `T` items
+ */
+inline detail::unbatch_stage unbatch()
+{
+  return detail::unbatch_stage();
+}
+
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_BATCH_HPP
@@ -0,0 +1,138 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_CACHE_HPP
+#define BOOST_PIPELINE_CACHE_HPP
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <boost/pipeline/detail/segment.hpp>
+#include <boost/pipeline/detail/clock_cache.hpp>
+
+namespace boost {
+namespace pipeline {
+
+namespace detail {
+
+/** Decayed argument and result type of a unary function */
+template <typename F>
+struct unary_signature : unary_signature<decltype(&F::operator())> {};
+
+template <typename R, typename A>
+struct unary_signature<R(*)(A)>
+{
+  typedef typename std::decay<A>::type argument_type;
+  typedef typename std::decay<R>::type result_type;
+};
+
+template <typename C, typename R, typename A>
+struct unary_signature<R(C::*)(A)> : unary_signature<R(*)(A)> {};
+
+template <typename C, typename R, typename A>
+struct unary_signature<R(C::*)(A) const> : unary_signature<R(*)(A)> {};
+
+template <typename Function>
+class cached_stage
+{
+  typedef typename unary_signature<Function>::argument_type key_type;
+  typedef typename unary_signature<Function>::result_type value_type;
+
+  struct shared_state
+  {
+    explicit shared_state(std::size_t capacity)
+      :cache(capacity),
+       hits(0),
+       misses(0)
+    {}
+
+    clock_cache<key_type, value_type> cache;
+    std::atomic<std::uint64_t> hits;
+    std::atomic<std::uint64_t> misses;
+  };
+
+public:
+  template <typename Plan>
+  using connect_type = one_one_segment<Plan, value_type>;
+
+  cached_stage(const Function& function, std::size_t capacity)
+    :_function(function),
+     _state(std::make_shared<shared_state>(capacity))
+  {}
+
+  // templated, to be connected using connect_type
+  template <typename Key>
+  value_type operator()(const Key& key) const
+  {
+    value_type value;
+    if (_state->cache.find(key, value))
+    {
+      ++_state->hits;
+      return value;
+    }
+
+    ++_state->misses;
+
+    // computed without holding the cache: concurrent misses
+    // of the same key might call `_function` several times
+    value = _function(key);
+    _state->cache.insert(key, value);
+
+    return value;
+  }
+
+  std::uint64_t hits() const { return _state->hits; }
+  std::uint64_t misses() const { return _state->misses; }
+
+private:
+  Function _function;
+  std::shared_ptr<shared_state> _state; /**< shared among copies */
+};
+
+} // namespace detail
+
+/**
+ * Creates a 1-1 transformation which calls `function`
+ * only if its result for the given input isn't cached.
+ *
+ * At most `capacity` results are kept, evicted using the CLOCK
+ * algorithm (an approximation of LRU). The cache and the hit and miss
+ * counters are shared among the copies of the returned stage,
+ * therefore it works the same if the stage is used by several segments
+ * at once:
+ *
+ * @code
+ * auto get_user_cached = cached(get_user, 10000);
+ * auto exec = (from(names) | find_uid | get_user_cached | print).run(pool);
+ * exec.wait();
+ * std::uint64_t hits = get_user_cached.hits();
+ * @endcode
+ *
+ * @param function `V function(K)`, `K` must be hashable by `std::hash`,
+ *                 `V` must be default constructible and copyable
+ * @param capacity Maximum number of cached results
+ * @returns A transformation of `K` items to `V` items
+ */
+template <typename Function>
+detail::cached_stage<Function>
+cached(Function function, std::size_t capacity)
+{
+  return detail::cached_stage<Function>(function, capacity);
+}
+
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_CACHE_HPP
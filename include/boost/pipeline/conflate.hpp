@@ -0,0 +1,143 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_CONFLATE_HPP
+#define BOOST_PIPELINE_CONFLATE_HPP
+
+#include <list>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <unordered_map>
+
+#include <boost/pipeline/queue.hpp>
+#include <boost/pipeline/detail/segment.hpp>
+#include <boost/pipeline/detail/hold_back.hpp>
+
+namespace boost {
+namespace pipeline {
+
+namespace detail {
+
+/**
+ * Pending items, at most one for each key, in the order
+ * their keys arrived. A newer item replaces the pending
+ * item of the same key in place.
+ */
+template <typename Key, typename T>
+class conflation_buffer
+{
+  typedef std::list<std::pair<Key, T>> list_type;
+
+public:
+  /** @returns false, if an item of the same key is replaced */
+  bool put(const Key& key, T&& item)
+  {
+    auto found = _index.find(key);
+    if (found != _index.end())
+    {
+      found->second->second = std::move(item);
+      return false;
+    }
+
+    _items.emplace_back(key, std::move(item));
+    _index.emplace(key, std::prev(_items.end()));
+    return true;
+  }
+
+  /** @pre `! empty()` */
+  T pop()
+  {
+    T item = std::move(_items.front().second);
+    _index.erase(_items.front().first);
+    _items.pop_front();
+    return item;
+  }
+
+  bool empty() const { return _items.empty(); }
+  std::size_t size() const { return _index.size(); }
+
+private:
+  list_type _items;
+  std::unordered_map<Key, typename list_type::iterator> _index;
+};
+
+template <typename KeyFn>
+class conflate_stage
+{
+public:
+  template <typename Plan>
+  using connect_type = n_m_segment<Plan, typename Plan::value_type, void>;
+
+  conflate_stage(const KeyFn& key_fn, std::size_t max_depth)
+    :_key_fn(key_fn),
+     _max_depth(std::max<std::size_t>(1, max_depth))
+  {}
+
+  template <typename T>
+  void operator()(queue_front<T>& upstream, queue_back<T>& downstream) const
+  {
+    typedef typename std::decay<
+      decltype(std::declval<const KeyFn&>()(std::declval<const T&>()))
+    >::type key_type;
+
+    // whole-stream stage, hold_back handles the cancellation
+    conflation_buffer<key_type, T> pending;
+
+    const KeyFn& key_fn = _key_fn;
+    hold_back(upstream, downstream, _max_depth, pending,
+      [&key_fn](conflation_buffer<key_type, T>& buffer, T&& item)
+      {
+        const key_type key = key_fn(item);
+        buffer.put(key, std::move(item));
+      }
+    );
+  }
+
+private:
+  KeyFn _key_fn;
+  std::size_t _max_depth;
+};
+
+} // namespace detail
+
+/**
+ * Creates a stage which keeps only the latest item of each key
+ * while the downstream is busy.
+ *
+ * Items are passed on while the downstream queue holds less than
+ * `max_depth` items. Otherwise, they are held back: a newer item
+ * replaces the pending item of the same key, keeping its position.
+ * Therefore the consumer only processes the most recent items
+ * and the number of pending items is bounded by the number of keys.
+ *
+ * @code
+ * auto instrument = [](const quote& q) { return q.symbol; };
+ * from(feed) | conflate(instrument) | reprice
+ * @endcode
+ *
+ * @param key_fn Key of an item, `K key_fn(const T&)`, `K` must be hashable by `std::hash`
+ * @param max_depth Number of items the downstream queue may hold
+ * @returns A transformation of `T` items to the latest ones of each key
+ */
+template <typename KeyFn>
+detail::conflate_stage<KeyFn>
+conflate(KeyFn key_fn, std::size_t max_depth = 1)
+{
+  return detail::conflate_stage<KeyFn>(key_fn, max_depth);
+}
+
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_CONFLATE_HPP
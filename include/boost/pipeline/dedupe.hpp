@@ -0,0 +1,160 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_DEDUPE_HPP
+#define BOOST_PIPELINE_DEDUPE_HPP
+
+#include <cstddef>
+#include <utility>
+#include <functional>
+#include <type_traits>
+
+#include <boost/assert.hpp>
+
+#include <boost/pipeline/queue.hpp>
+#include <boost/pipeline/detail/hash.hpp>
+#include <boost/pipeline/detail/segment.hpp>
+#include <boost/pipeline/detail/whole_stream.hpp>
+#include <boost/pipeline/detail/bloom_filter.hpp>
+#include <boost/pipeline/detail/flat_hash_table.hpp>
+
+namespace boost {
+namespace pipeline {
+
+namespace detail {
+
+template <typename KeyFn, typename T>
+using key_type_of = typename std::decay<
+  decltype(std::declval<const KeyFn&>()(std::declval<const T&>()))
+>::type;
+
+template <typename KeyFn>
+class bloom_dedupe_stage
+{
+public:
+  template <typename Plan>
+  using connect_type = n_m_segment<Plan, typename Plan::value_type, void>;
+
+  bloom_dedupe_stage(const KeyFn& key_fn, std::size_t expected_size, double fp_rate)
+    :_key_fn(key_fn),
+     _expected_size(expected_size),
+     _fp_rate(fp_rate)
+  {}
+
+  template <typename T>
+  void operator()(queue_front<T>& upstream, queue_back<T>& downstream) const
+  {
+    // whole-stream stage, see pull_or_cancel
+    blocked_bloom_filter seen(_expected_size, _fp_rate);
+
+    T item;
+    while (pull_or_cancel(upstream, downstream, item))
+    {
+      if (seen.insert(hash_of(_key_fn(item))))
+      {
+        downstream.push(std::move(item));
+      }
+    }
+  }
+
+private:
+  KeyFn _key_fn;
+  std::size_t _expected_size;
+  double _fp_rate;
+};
+
+template <typename KeyFn>
+class exact_dedupe_stage
+{
+public:
+  template <typename Plan>
+  using connect_type = n_m_segment<Plan, typename Plan::value_type, void>;
+
+  explicit exact_dedupe_stage(const KeyFn& key_fn)
+    :_key_fn(key_fn)
+  {}
+
+  template <typename T>
+  void operator()(queue_front<T>& upstream, queue_back<T>& downstream) const
+  {
+    // whole-stream stage, see pull_or_cancel
+    flat_hash_table<key_type_of<KeyFn, T>, bool> seen;
+
+    T item;
+    while (pull_or_cancel(upstream, downstream, item))
+    {
+      if (seen.insert(_key_fn(item), true).second)
+      {
+        downstream.push(std::move(item));
+      }
+    }
+  }
+
+private:
+  KeyFn _key_fn;
+};
+
+} // namespace detail
+
+/**
+ * Creates a stage which drops the items of already seen keys,
+ * using a Bloom filter.
+ *
+ * The keys are not stored: the filter takes about
+ * `-1.44 * log2(fp_rate)` bits for each of the `expected_size` keys,
+ * rounded up to a power of two, e.g: 2 MB for a million keys at 1%.
+ * Each key is looked up in a single 256 bit block. In turn,
+ * an item of a new key is dropped with a probability of about `fp_rate`
+ * if at most `expected_size` distinct keys arrive, more if the estimate
+ * is exceeded.
+ *
+ * @code
+ * from(events) | dedupe(get_event_id, 100000000, 0.001) | process
+ * @endcode
+ *
+ * @param key_fn Key of an item, `K key_fn(const T&)`, hashable by `std::hash`
+ * @param expected_size Expected number of distinct keys, must be positive
+ * @param fp_rate Accepted ratio of dropped new items, in (0, 1),
+ *                if asserts are disabled, out of range values are clamped
+ * @returns A transformation of `T` items to `T` items of distinct keys
+ */
+template <typename KeyFn>
+detail::bloom_dedupe_stage<KeyFn>
+dedupe(KeyFn key_fn, std::size_t expected_size, double fp_rate)
+{
+  BOOST_ASSERT(expected_size > 0);
+  BOOST_ASSERT(fp_rate > 0 && fp_rate < 1);
+
+  return detail::bloom_dedupe_stage<KeyFn>(key_fn, expected_size, fp_rate);
+}
+
+/**
+ * Creates a stage which drops the items of already seen keys.
+ *
+ * Every distinct key is stored in an open addressing hash set,
+ * suitable if the number of keys is small.
+ *
+ * @param key_fn Key of an item, `K key_fn(const T&)`, hashable by `std::hash`
+ *               and default constructible
+ * @returns A transformation of `T` items to `T` items of distinct keys
+ */
+template <typename KeyFn>
+detail::exact_dedupe_stage<KeyFn>
+dedupe(KeyFn key_fn)
+{
+  return detail::exact_dedupe_stage<KeyFn>(key_fn);
+}
+
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_DEDUPE_HPP
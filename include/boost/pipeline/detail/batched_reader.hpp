@@ -0,0 +1,91 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_DETAIL_BATCHED_READER_HPP
+#define BOOST_PIPELINE_DETAIL_BATCHED_READER_HPP
+
+#include <vector>
+#include <cstddef>
+
+#include <boost/pipeline/queue.hpp>
+
+namespace boost {
+namespace pipeline {
+namespace detail {
+
+/**
+ * Reads a queue in batches of at most `batch_size` items,
+ * the front item can be inspected before it is consumed.
+ */
+template <typename T>
+class batched_reader
+{
+public:
+  batched_reader(queue<T>& queue, std::size_t batch_size)
+    :_upstream(queue),
+     _batch_size(batch_size),
+     _position(0)
+  {}
+
+  /**
+   * Blocks until an item is available or the queue gets closed.
+   *
+   * @returns true, if there is a front item, false if the queue is exhausted
+   */
+  bool has_front()
+  {
+    if (_position < _buffer.size()) { return true; }
+
+    _buffer.clear();
+    _position = 0;
+
+    T item;
+    if (! _upstream.wait_pull(item)) { return false; }
+    _buffer.push_back(std::move(item));
+
+    while (_buffer.size() < _batch_size && _upstream.try_pull(item))
+    {
+      _buffer.push_back(std::move(item));
+    }
+
+    return true;
+  }
+
+  /** @pre `has_front()` returned true */
+  T& front() { return _buffer[_position]; }
+
+  /** @pre `has_front()` returned true */
+  void pop() { ++_position; }
+
+  /**
+   * Signals the producers that no more items are needed,
+   * and discards the remaining items.
+   */
+  void cancel()
+  {
+    _buffer.clear();
+    _position = 0;
+    _upstream.cancel();
+  }
+
+private:
+  queue_front<T> _upstream;
+  std::size_t _batch_size;
+  std::vector<T> _buffer;
+  std::size_t _position;
+};
+
+} // namespace detail
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_DETAIL_BATCHED_READER_HPP
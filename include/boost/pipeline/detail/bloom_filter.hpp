@@ -0,0 +1,137 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_DETAIL_BLOOM_FILTER_HPP
+#define BOOST_PIPELINE_DETAIL_BLOOM_FILTER_HPP
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+namespace boost {
+namespace pipeline {
+namespace detail {
+
+/**
+ * Bloom filter of 256 bit blocks.
+ *
+ * Each hash is mapped to a single block and sets one bit
+ * in each of its eight 32 bit words, a lookup touches a single cache line.
+ * The word-wise loops are independent of each other, compilers
+ * turn them into vector instructions.
+ */
+class blocked_bloom_filter
+{
+  static const std::size_t words_per_block = 8;
+
+public:
+  /**
+   * Out of range arguments are clamped: a rate of at most 0
+   * is taken as 1e-9, a rate of at least 1 as 0.5 and
+   * an `expected_size` of 0 as 1.
+   *
+   * @param expected_size Expected number of distinct inserted hashes, positive
+   * @param fp_rate Desired false positive rate, in (0, 1)
+   */
+  blocked_bloom_filter(std::size_t expected_size, double fp_rate)
+  {
+    // NaN is taken as 0
+    if (! (fp_rate > 0)) { fp_rate = 1e-9; }
+    if (fp_rate >= 1)    { fp_rate = 0.5; }
+
+    // k = 8 bits per hash: m = -k * n / ln(1 - p^(1/k))
+    const double bits = -8.0 * static_cast<double>(std::max<std::size_t>(1, expected_size))
+      / std::log(1.0 - std::pow(fp_rate, 1.0 / 8));
+
+    std::size_t blocks = 1;
+    while (static_cast<double>(blocks * words_per_block * 32) < bits) { blocks *= 2; }
+
+    _words.assign(blocks * words_per_block, 0);
+    _block_mask = blocks - 1;
+  }
+
+  /**
+   * Adds `hash` to the set.
+   *
+   * @returns false, if `hash` was (probably) already present
+   */
+  bool insert(std::uint64_t hash)
+  {
+    std::uint32_t* block = &_words[block_of(hash) * words_per_block];
+    const std::uint32_t key = static_cast<std::uint32_t>(hash);
+
+    std::uint32_t masks[words_per_block];
+    make_masks(key, masks);
+
+    std::uint32_t missing = 0;
+    for (std::size_t i = 0; i < words_per_block; ++i)
+    {
+      missing |= masks[i] & ~block[i];
+      block[i] |= masks[i];
+    }
+
+    return missing != 0;
+  }
+
+  /** @returns false, if `hash` is certainly not present */
+  bool contains(std::uint64_t hash) const
+  {
+    const std::uint32_t* block = &_words[block_of(hash) * words_per_block];
+    const std::uint32_t key = static_cast<std::uint32_t>(hash);
+
+    std::uint32_t masks[words_per_block];
+    make_masks(key, masks);
+
+    std::uint32_t missing = 0;
+    for (std::size_t i = 0; i < words_per_block; ++i)
+    {
+      missing |= masks[i] & ~block[i];
+    }
+
+    return missing == 0;
+  }
+
+  std::size_t size_in_bytes() const
+  {
+    return _words.size() * sizeof(std::uint32_t);
+  }
+
+private:
+  static void make_masks(std::uint32_t key, std::uint32_t (&masks)[words_per_block])
+  {
+    static const std::uint32_t salt[words_per_block] = {
+      0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+      0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+    };
+
+    for (std::size_t i = 0; i < words_per_block; ++i)
+    {
+      masks[i] = std::uint32_t(1) << ((key * salt[i]) >> 27);
+    }
+  }
+
+  std::size_t block_of(std::uint64_t hash) const
+  {
+    return static_cast<std::size_t>(hash >> 32) & _block_mask;
+  }
+
+  std::vector<std::uint32_t> _words;
+  std::size_t _block_mask;
+};
+
+} // namespace detail
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_DETAIL_BLOOM_FILTER_HPP
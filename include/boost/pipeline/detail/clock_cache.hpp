@@ -0,0 +1,108 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_DETAIL_CLOCK_CACHE_HPP
+#define BOOST_PIPELINE_DETAIL_CLOCK_CACHE_HPP
+
+#include <vector>
+#include <mutex>
+#include <cstddef>
+#include <unordered_map>
+
+namespace boost {
+namespace pipeline {
+namespace detail {
+
+/**
+ * Thread-safe cache of at most `capacity` entries,
+ * evicting using the CLOCK algorithm.
+ *
+ * A hit only marks the entry as referenced. If the cache is full,
+ * the clock hand sweeps the entries, clearing the marks,
+ * and evicts the first unmarked one: an approximation of LRU.
+ */
+template <typename Key, typename Value>
+class clock_cache
+{
+  struct entry
+  {
+    Key key;
+    Value value;
+    bool referenced;
+  };
+
+public:
+  explicit clock_cache(std::size_t capacity)
+    :_capacity(capacity),
+     _hand(0)
+  {
+    _entries.reserve(capacity);
+    _index.reserve(capacity);
+  }
+
+  /** @returns true, if `key` is found, its value is copied to `value` */
+  bool find(const Key& key, Value& value)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _index.find(key);
+    if (it == _index.end()) { return false; }
+
+    entry& e = _entries[it->second];
+    e.referenced = true;
+    value = e.value;
+
+    return true;
+  }
+
+  void insert(const Key& key, const Value& value)
+  {
+    if (_capacity == 0) { return; }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // inserted concurrently
+    if (_index.find(key) != _index.end()) { return; }
+
+    if (_entries.size() < _capacity)
+    {
+      _index[key] = _entries.size();
+      _entries.push_back(entry{key, value, false});
+      return;
+    }
+
+    while (_entries[_hand].referenced)
+    {
+      _entries[_hand].referenced = false;
+      _hand = (_hand + 1) % _capacity;
+    }
+
+    _index.erase(_entries[_hand].key);
+    _index[key] = _hand;
+    _entries[_hand] = entry{key, value, false};
+
+    _hand = (_hand + 1) % _capacity;
+  }
+
+private:
+  std::mutex _mutex;
+  std::size_t _capacity;
+  std::size_t _hand; /**< next candidate of eviction */
+  std::vector<entry> _entries;
+  std::unordered_map<Key, std::size_t> _index;
+};
+
+} // namespace detail
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_DETAIL_CLOCK_CACHE_HPP
@@ -116,6 +116,14 @@ class connector
     -> typename bind_connector<Plan, Bind>::type
   ;
 
+  //
+  // Connect stages provided by the library
+  // (types are deduced from the upstream segment)
+  //
+
+  template <typename Stage>
+  static typename Stage::template connect_type<Plan> connect(const Stage& stage);
+
   //
   // Connect container (sink)
   //
@@ -0,0 +1,192 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_DETAIL_FLAT_HASH_TABLE_HPP
+#define BOOST_PIPELINE_DETAIL_FLAT_HASH_TABLE_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <functional>
+
+namespace boost {
+namespace pipeline {
+namespace detail {
+
+/**
+ * Open addressing hash table using linear probing.
+ *
+ * Slots are stored in a single contiguous array,
+ * lookups touch adjacent memory only. The same key might be
+ * inserted several times using `insert_multi`. Items can't be erased.
+ *
+ * `Key` and `Value` must be default constructible.
+ */
+template <
+  typename Key,
+  typename Value,
+  typename Hash = std::hash<Key>,
+  typename KeyEqual = std::equal_to<Key>
+>
+class flat_hash_table
+{
+  struct slot
+  {
+    bool used = false;
+    Key key;
+    Value value;
+  };
+
+public:
+  explicit flat_hash_table(std::size_t expected_size = 0)
+    :_size(0)
+  {
+    rehash(capacity_for(expected_size));
+  }
+
+  std::size_t size() const { return _size; }
+  bool empty() const { return _size == 0; }
+
+  /** Inserts `value` even if `key` is already present */
+  void insert_multi(const Key& key, Value value)
+  {
+    reserve_one();
+
+    slot& s = _slots[find_free(key)];
+    s.used = true;
+    s.key = key;
+    s.value = std::move(value);
+    ++_size;
+  }
+
+  /**
+   * Gets the value associated with `key`, inserts `value`
+   * if `key` is not present.
+   *
+   * @returns The value associated with `key` and true if it's inserted
+   */
+  std::pair<Value*, bool> insert(const Key& key, Value value)
+  {
+    Value* found = find(key);
+    if (found) { return std::make_pair(found, false); }
+
+    reserve_one();
+
+    slot& s = _slots[find_free(key)];
+    s.used = true;
+    s.key = key;
+    s.value = std::move(value);
+    ++_size;
+
+    return std::make_pair(&s.value, true);
+  }
+
+  /** @returns Pointer to the first value associated with `key` or nullptr */
+  Value* find(const Key& key)
+  {
+    for (std::size_t i = index_of(key); _slots[i].used; i = next(i))
+    {
+      if (_equal(_slots[i].key, key)) { return &_slots[i].value; }
+    }
+
+    return nullptr;
+  }
+
+  /** @copydoc find */
+  const Value* find(const Key& key) const
+  {
+    return const_cast<flat_hash_table*>(this)->find(key);
+  }
+
+  /** Calls `f(value)` for each value associated with `key` */
+  template <typename F>
+  void for_each_match(const Key& key, F&& f) const
+  {
+    for (std::size_t i = index_of(key); _slots[i].used; i = next(i))
+    {
+      if (_equal(_slots[i].key, key)) { f(_slots[i].value); }
+    }
+  }
+
+  /** Calls `f(key, value)` for each item */
+  template <typename F>
+  void for_each(F&& f) const
+  {
+    for (const slot& s : _slots)
+    {
+      if (s.used) { f(s.key, s.value); }
+    }
+  }
+
+  void clear()
+  {
+    _slots.assign(_slots.size(), slot());
+    _size = 0;
+  }
+
+private:
+  static std::size_t capacity_for(std::size_t size)
+  {
+    std::size_t capacity = 16;
+    while (capacity / 4 * 3 < size) { capacity *= 2; }
+    return capacity;
+  }
+
+  std::size_t index_of(const Key& key) const
+  {
+    // fibonacci hashing: spread poor hashes (e.g: identity) on the table
+    const std::uint64_t h = static_cast<std::uint64_t>(_hash(key)) * 0x9E3779B97F4A7C15ull;
+    return static_cast<std::size_t>(h >> 32) & _mask;
+  }
+
+  std::size_t next(std::size_t i) const { return (i + 1) & _mask; }
+
+  std::size_t find_free(const Key& key) const
+  {
+    std::size_t i = index_of(key);
+    while (_slots[i].used) { i = next(i); }
+    return i;
+  }
+
+  void reserve_one()
+  {
+    if ((_size + 1) > _slots.size() / 4 * 3)
+    {
+      rehash(_slots.size() * 2);
+    }
+  }
+
+  void rehash(std::size_t capacity)
+  {
+    std::vector<slot> old(capacity);
+    old.swap(_slots);
+    _mask = capacity - 1;
+
+    for (slot& s : old)
+    {
+      if (s.used) { _slots[find_free(s.key)] = std::move(s); }
+    }
+  }
+
+  std::vector<slot> _slots;
+  std::size_t _size;
+  std::size_t _mask;
+  Hash _hash;
+  KeyEqual _equal;
+};
+
+} // namespace detail
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_DETAIL_FLAT_HASH_TABLE_HPP
@@ -0,0 +1,45 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_DETAIL_HASH_HPP
+#define BOOST_PIPELINE_DETAIL_HASH_HPP
+
+#include <cstdint>
+#include <functional>
+
+namespace boost {
+namespace pipeline {
+namespace detail {
+
+/** Spreads the bits of a hash (e.g: identity) over 64 bits */
+inline std::uint64_t mix_hash(std::uint64_t h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ull;
+  h ^= h >> 33;
+  return h;
+}
+
+/** @returns `std::hash` of `item`, mixed over 64 bits */
+template <typename T>
+std::uint64_t hash_of(const T& item)
+{
+  return mix_hash(std::hash<T>()(item));
+}
+
+} // namespace detail
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_DETAIL_HASH_HPP
@@ -0,0 +1,115 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_DETAIL_HOLD_BACK_HPP
+#define BOOST_PIPELINE_DETAIL_HOLD_BACK_HPP
+
+#include <chrono>
+#include <thread>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+
+#include <boost/pipeline/queue.hpp>
+
+namespace boost {
+namespace pipeline {
+namespace detail {
+
+/**
+ * Forwards the items of `upstream` to `downstream`, but holds them
+ * back in `pending` while `downstream` has at least `max_depth` items.
+ *
+ * `Buffer` decides what and in which order is forwarded,
+ * it must provide `T pop()` and `bool empty()`. Items are added
+ * to the buffer by calling `put(pending, std::move(item))`.
+ *
+ * Returns if the whole stream is forwarded or the downstream
+ * gets cancelled. In the latter case, the upstream is cancelled,
+ * as required from whole-stream stages (see `pull_or_cancel()`).
+ */
+template <typename T, typename Buffer, typename Put>
+void hold_back(
+  queue_front<T>& upstream,
+  queue_back<T>& downstream,
+  std::size_t max_depth,
+  Buffer& pending,
+  const Put& put
+)
+{
+  // upper bound of items pulled between two checks of the downstream
+  const std::size_t max_pull = 1024;
+
+  const std::chrono::microseconds max_backoff(1000);
+  std::chrono::microseconds backoff(20);
+
+  bool has_input = true;
+
+  T item;
+  while (has_input || ! pending.empty())
+  {
+    if (downstream.is_cancelled())
+    {
+      upstream.cancel();
+      return;
+    }
+
+    bool progress = false;
+
+    while (! pending.empty() && downstream.size() < max_depth)
+    {
+      downstream.push(pending.pop());
+      progress = true;
+    }
+
+    if (has_input && pending.empty())
+    {
+      // nothing to forward but the upstream
+      has_input = upstream.wait_pull(item);
+      if (has_input) { put(pending, std::move(item)); }
+      progress = true;
+    }
+    else if (has_input)
+    {
+      bool pulled = false;
+      for (std::size_t i = 0; i < max_pull && upstream.try_pull(item); ++i)
+      {
+        put(pending, std::move(item));
+        pulled = true;
+      }
+
+      if (! pulled && upstream.is_closed() && upstream.is_empty())
+      {
+        has_input = false;
+      }
+
+      progress = progress || pulled || ! has_input;
+    }
+
+    if (progress)
+    {
+      backoff = std::chrono::microseconds(20);
+    }
+    else
+    {
+      // wait for the consumer or the upstream
+      std::this_thread::sleep_for(backoff);
+      backoff = std::min(backoff * 2, max_backoff);
+    }
+  }
+}
+
+} // namespace detail
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_DETAIL_HOLD_BACK_HPP
@@ -0,0 +1,137 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_DETAIL_SPILL_FILE_HPP
+#define BOOST_PIPELINE_DETAIL_SPILL_FILE_HPP
+
+#include <cstdio>
+#include <cstddef>
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+namespace boost {
+namespace pipeline {
+namespace detail {
+
+inline void spill_write(std::FILE* file, const void* data, std::size_t size)
+{
+  if (size && std::fwrite(data, size, 1, file) != 1)
+  {
+    throw std::runtime_error("Failed to write spill file");
+  }
+}
+
+inline bool spill_read(std::FILE* file, void* data, std::size_t size)
+{
+  return size == 0 || std::fread(data, size, 1, file) == 1;
+}
+
+/**
+ * Binary representation of spilled items.
+ *
+ * Supports trivially copyable types and `std::basic_string`s of them.
+ */
+template <typename T, typename Enable = void>
+struct spill_codec;
+
+template <typename T>
+struct spill_codec<T, typename std::enable_if<std::is_trivially_copyable<T>::value>::type>
+{
+  static void write(std::FILE* file, const T& item)
+  {
+    spill_write(file, &item, sizeof(T));
+  }
+
+  static bool read(std::FILE* file, T& item)
+  {
+    return spill_read(file, &item, sizeof(T));
+  }
+};
+
+template <typename Char, typename Traits, typename Allocator>
+struct spill_codec<std::basic_string<Char, Traits, Allocator>>
+{
+  typedef std::basic_string<Char, Traits, Allocator> string_type;
+
+  static void write(std::FILE* file, const string_type& item)
+  {
+    const std::size_t length = item.size();
+    spill_write(file, &length, sizeof(length));
+    spill_write(file, item.data(), length * sizeof(Char));
+  }
+
+  static bool read(std::FILE* file, string_type& item)
+  {
+    std::size_t length;
+    if (! spill_read(file, &length, sizeof(length))) { return false; }
+
+    item.resize(length);
+    return spill_read(file, &item[0], length * sizeof(Char));
+  }
+};
+
+/** true, if `T` items can be spilled, i.e: `spill_codec<T>` is defined */
+template <typename T, typename Enable = void>
+struct has_spill_codec : std::false_type {};
+
+template <typename T>
+struct has_spill_codec<T, decltype(void(sizeof(spill_codec<T>)))> : std::true_type {};
+
+/**
+ * Anonymous temporary file of `T` items,
+ * written once, then read back sequentially.
+ *
+ * The file is removed when closed.
+ */
+template <typename T>
+class spill_file
+{
+public:
+  spill_file()
+    :_file(std::tmpfile(), &std::fclose)
+  {
+    if (! _file) { throw std::runtime_error("Failed to create spill file"); }
+  }
+
+  void write(const T& item)
+  {
+    spill_codec<T>::write(_file.get(), item);
+  }
+
+  /** Prepares the file for reading, from the first item */
+  void rewind()
+  {
+    if (std::fflush(_file.get()) != 0)
+    {
+      throw std::runtime_error("Failed to write spill file");
+    }
+
+    std::rewind(_file.get());
+  }
+
+  /** @returns false, if there are no more items */
+  bool read(T& item)
+  {
+    return spill_codec<T>::read(_file.get(), item);
+  }
+
+private:
+  std::unique_ptr<std::FILE, int(*)(std::FILE*)> _file;
+};
+
+} // namespace detail
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_DETAIL_SPILL_FILE_HPP
@@ -14,6 +14,8 @@
 #define BOOST_PIPELINE_DETAIL_TASK_HPP
 
 #include <memory>
+#include <future>
+#include <exception>
 
 #include <boost/pipeline/queue.hpp>
 
@@ -21,26 +23,34 @@ namespace boost {
 namespace pipeline {
 namespace detail {
 
+/** Completes the execution of a sink, failed if `error` is set */
+inline void complete(std::promise<void>& promise, const std::exception_ptr& error)
+{
+  if (error) { promise.set_exception(error); }
+  else       { promise.set_value(); }
+}
+
 template <typename Input, typename Output, typename Transformation>
 class basic_task
 {
 public:
   queue_back<Input> get_queue_back()
   {
-    return queue_back<Input>(*_input);
+    return queue_back<Input>(_input);
   }
 
 protected:
   basic_task(
     const Transformation& function,
-    const queue_back<Output>& downstream
+    const queue_back<Output>& downstream,
+    const std::shared_ptr<queue<Input>>& input = std::make_shared<queue<Input>>()
   )
-    :_input(new queue<Input>()),
+    :_input(input),
      _downstream(downstream),
      _transformation(function)
   {}
 
-  std::unique_ptr<queue<Input>> _input;
+  std::shared_ptr<queue<Input>> _input;
   queue_back<Output> _downstream;
   Transformation _transformation;
 };
@@ -62,14 +72,26 @@ public:
   {
     queue_front<Input> upstream(*base::_input);
 
-    Input input;
-    while (upstream.wait_pull(input))
+    try
     {
-      auto output = base::_transformation(std::move(input));
-      base::_downstream.push(std::move(output));
+      Input input;
+      while (upstream.wait_pull(input))
+      {
+        if (base::_downstream.is_cancelled()) { upstream.cancel(); break; }
+
+        auto output = base::_transformation(std::move(input));
+        base::_downstream.push(std::move(output));
+      }
+    }
+    catch (...)
+    {
+      // reported by execution::wait(), the items are not needed anymore
+      upstream.cancel();
+      base::_downstream.close(std::current_exception());
+      return;
     }
 
-    base::_downstream.close();
+    base::_downstream.close(upstream.error());
   }
 
   using base::get_queue_back;
@@ -93,13 +115,25 @@ public:
   {
     queue_front<Input> upstream(*base::_input);
 
-    Input input;
-    while (upstream.wait_pull(input))
+    try
     {
-      base::_transformation(std::move(input), base::_downstream);
+      Input input;
+      while (upstream.wait_pull(input))
+      {
+        if (base::_downstream.is_cancelled()) { upstream.cancel(); break; }
+
+        base::_transformation(std::move(input), base::_downstream);
+      }
+    }
+    catch (...)
+    {
+      // reported by execution::wait(), the items are not needed anymore
+      upstream.cancel();
+      base::_downstream.close(std::current_exception());
+      return;
     }
 
-    base::_downstream.close();
+    base::_downstream.close(upstream.error());
   }
 
   using base::get_queue_back;
@@ -123,13 +157,25 @@ public:
   {
     queue_front<Input> upstream(*base::_input);
 
-    while (! upstream.is_empty() || ! upstream.is_closed())
+    try
     {
-      auto output = base::_transformation(upstream);
-      base::_downstream.push(std::move(output));
+      while (! upstream.is_empty() || ! upstream.is_closed())
+      {
+        if (base::_downstream.is_cancelled()) { upstream.cancel(); break; }
+
+        auto output = base::_transformation(upstream);
+        base::_downstream.push(std::move(output));
+      }
+    }
+    catch (...)
+    {
+      // reported by execution::wait(), the items are not needed anymore
+      upstream.cancel();
+      base::_downstream.close(std::current_exception());
+      return;
     }
 
-    base::_downstream.close();
+    base::_downstream.close(upstream.error());
   }
 
   using base::get_queue_back;
@@ -149,16 +195,40 @@ public:
     :base(function, downstream)
   {}
 
+  /** The task pulls from `input`, which might be shared by several tasks */
+  n_m_task(
+    const Transformation& function,
+    const queue_back<Output>& downstream,
+    const std::shared_ptr<queue<Input>>& input
+  )
+    :base(function, downstream, input)
+  {}
+
   void operator()()
   {
     queue_front<Input> upstream(*base::_input);
 
-    while (! upstream.is_empty() || ! upstream.is_closed())
+    try
     {
-      base::_transformation(upstream, base::_downstream);
+      while (! upstream.is_empty() || ! upstream.is_closed())
+      {
+        if (base::_downstream.is_cancelled()) { upstream.cancel(); break; }
+
+        // the transformation needs no more items
+        if (upstream.is_cancelled()) { break; }
+
+        base::_transformation(upstream, base::_downstream);
+      }
+    }
+    catch (...)
+    {
+      // reported by execution::wait(), the items are not needed anymore
+      upstream.cancel();
+      base::_downstream.close(std::current_exception());
+      return;
     }
 
-    base::_downstream.close();
+    base::_downstream.close(upstream.error());
   }
 
   using base::get_queue_back;
@@ -180,7 +250,7 @@ public:
 
   void operator()()
   {
-    while (_current != _end)
+    while (_current != _end && ! _downstream.is_cancelled())
     {
       _downstream.push(*_current);
       ++_current;
@@ -212,12 +282,12 @@ public:
     queue_front<Output> upstream(_queue);
 
     Output output;
-    while (upstream.wait_pull(output))
+    while (! _downstream.is_cancelled() && upstream.wait_pull(output))
     {
       _downstream.push(std::move(output));
     }
 
-    _downstream.close();
+    _downstream.close(upstream.error());
   }
 
 private:
@@ -239,7 +309,17 @@ public:
 
   void operator()()
   {
-    _generator(_downstream);
+    try
+    {
+      _generator(_downstream);
+    }
+    catch (...)
+    {
+      // reported by execution::wait()
+      _downstream.close(std::current_exception());
+      return;
+    }
+
     _downstream.close();
   }
 
@@ -257,7 +337,7 @@ public:
     const std::back_insert_iterator<Container>& out_it
   )
     :_promise(std::move(promise)),
-     _input(new queue<Input>()),
+     _input(std::make_shared<queue<Input>>()),
      _out_it(out_it)
   {}
 
@@ -271,17 +351,17 @@ public:
       *_out_it = std::move(input);
     }
 
-    _promise.set_value();
+    complete(_promise, upstream.error());
   }
 
   queue_back<Input> get_queue_back()
   {
-    return queue_back<Input>(*_input);
+    return queue_back<Input>(_input);
   }
 
 private:
   std::promise<void> _promise;
-  std::unique_ptr<queue<Input>> _input;
+  std::shared_ptr<queue<Input>> _input;
   std::back_insert_iterator<Container> _out_it;
 };
 
@@ -305,7 +385,7 @@ public:
       std::this_thread::yield();
     }
 
-    _promise.set_value();
+    complete(_promise, _upstream.error());
   }
 
 private:
@@ -322,7 +402,7 @@ public:
     const Consumer& consumer
   )
     :_promise(std::move(promise)),
-     _input(new queue<Input>()),
+     _input(std::make_shared<queue<Input>>()),
      _consumer(consumer)
   {}
 
@@ -330,23 +410,33 @@ public:
   {
     queue_front<Input> upstream(*_input);
 
-    Input input;
-    while (upstream.wait_pull(input))
+    try
     {
-      _consumer(std::move(input));
+      Input input;
+      while (upstream.wait_pull(input))
+      {
+        _consumer(std::move(input));
+      }
+    }
+    catch (...)
+    {
+      // reported by execution::wait(), the items are not needed anymore
+      upstream.cancel();
+      _promise.set_exception(std::current_exception());
+      return;
     }
 
-    _promise.set_value();
+    complete(_promise, upstream.error());
   }
 
   queue_back<Input> get_queue_back()
   {
-    return queue_back<Input>(*_input);
+    return queue_back<Input>(_input);
   }
 
 private:
   std::promise<void> _promise;
-  std::unique_ptr<queue<Input>> _input;
+  std::shared_ptr<queue<Input>> _input;
   Consumer _consumer;
 };
 
@@ -359,7 +449,7 @@ public:
     const Consumer& consumer
   )
     :_promise(std::move(promise)),
-     _input(new queue<Input>()),
+     _input(std::make_shared<queue<Input>>()),
      _consumer(consumer)
   {}
 
@@ -367,22 +457,32 @@ public:
   {
     queue_front<Input> upstream(*_input);
 
-    while (! upstream.is_empty() || ! upstream.is_closed())
+    try
+    {
+      while (! upstream.is_empty() || ! upstream.is_closed())
+      {
+        _consumer(upstream);
+      }
+    }
+    catch (...)
     {
-      _consumer(upstream);
+      // reported by execution::wait(), the items are not needed anymore
+      upstream.cancel();
+      _promise.set_exception(std::current_exception());
+      return;
     }
 
-    _promise.set_value();
+    complete(_promise, upstream.error());
   }
 
   queue_back<Input> get_queue_back()
   {
-    return queue_back<Input>(*_input);
+    return queue_back<Input>(_input);
   }
 
 private:
   std::promise<void> _promise;
-  std::unique_ptr<queue<Input>> _input;
+  std::shared_ptr<queue<Input>> _input;
   Consumer _consumer;
 };
 
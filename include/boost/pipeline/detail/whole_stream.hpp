@@ -0,0 +1,61 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_DETAIL_WHOLE_STREAM_HPP
+#define BOOST_PIPELINE_DETAIL_WHOLE_STREAM_HPP
+
+#include <boost/pipeline/queue.hpp>
+
+namespace boost {
+namespace pipeline {
+namespace detail {
+
+/**
+ * Pulls the next item for a whole-stream stage.
+ *
+ * Whole-stream stages consume their entire input in a single call,
+ * to keep their state (an accumulator, a filter, a heap, ...) local
+ * to the call. The task running them checks the cancellation of the
+ * downstream only between two calls, therefore such a stage must
+ * check it on its own, and cancel its upstream in turn, otherwise
+ * the cancellation never reaches the source (see `take()`).
+ *
+ * Whole-stream stages pull their input using this function,
+ * and don't emit their remaining state if the downstream is cancelled:
+ *
+ * @code
+ * T item;
+ * while (pull_or_cancel(upstream, downstream, item)) { ... }
+ * if (downstream.is_cancelled()) { return; }
+ * @endcode
+ *
+ * @returns true, if an item is pulled, false if the upstream is exhausted
+ *          or the downstream is cancelled. In the latter case,
+ *          the upstream is cancelled.
+ */
+template <typename T, typename Downstream>
+bool pull_or_cancel(queue_front<T>& upstream, const Downstream& downstream, T& item)
+{
+  if (downstream.is_cancelled())
+  {
+    upstream.cancel();
+    return false;
+  }
+
+  return upstream.wait_pull(item);
+}
+
+} // namespace detail
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_DETAIL_WHOLE_STREAM_HPP
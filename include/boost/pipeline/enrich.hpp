@@ -0,0 +1,225 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_ENRICH_HPP
+#define BOOST_PIPELINE_ENRICH_HPP
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <utility>
+#include <functional>
+#include <type_traits>
+
+#include <boost/pipeline/detail/segment.hpp>
+#include <boost/pipeline/detail/flat_hash_table.hpp>
+
+namespace boost {
+namespace pipeline {
+
+/**
+ * Read-only lookup table of `Key` -> `Value` entries,
+ * which can be replaced while it's being read.
+ *
+ * Entries are stored in an open addressing hash table.
+ * Readers take a snapshot of the current table,
+ * `reset()` builds a new table and swaps it atomically:
+ * snapshots taken before keep seeing the old entries.
+ * Each swap increments a version counter, a `reader` keeps
+ * its snapshot until the version changes.
+ * Copies of a `lookup_table` refer to the same table.
+ *
+ * `Key` and `Value` must be default constructible,
+ * `Key` must be hashable by `std::hash`.
+ */
+template <typename Key, typename Value>
+class lookup_table
+{
+  struct state
+  {
+    explicit state(const std::shared_ptr<const detail::flat_hash_table<Key, Value>>& table)
+      :table(table),
+       version(0)
+    {}
+
+    std::shared_ptr<const detail::flat_hash_table<Key, Value>> table;
+    std::atomic<std::uint64_t> version; /**< incremented after each swap */
+  };
+
+public:
+  typedef detail::flat_hash_table<Key, Value> table_type;
+
+  /**
+   * Snapshot of a table, refreshed if the table is `reset()`.
+   *
+   * Looking up the current table costs a single acquire load
+   * unless the table is replaced. A reader must not be used
+   * by several threads at once.
+   */
+  class reader
+  {
+  public:
+    explicit reader(const lookup_table& table)
+      :_state(table._state),
+       _version(_state->version.load(std::memory_order_acquire)),
+       _snapshot(std::atomic_load(&_state->table))
+    {}
+
+    /** @returns The current table */
+    const table_type& get()
+    {
+      const std::uint64_t version = _state->version.load(std::memory_order_acquire);
+      if (version != _version)
+      {
+        _snapshot = std::atomic_load(&_state->table);
+        _version = version;
+      }
+
+      return *_snapshot;
+    }
+
+  private:
+    std::shared_ptr<state> _state;
+    std::uint64_t _version;
+    std::shared_ptr<const table_type> _snapshot;
+  };
+
+  /** Creates an empty table */
+  lookup_table()
+    :_state(std::make_shared<state>(std::make_shared<const table_type>()))
+  {}
+
+  /**
+   * Creates a table of `entries`
+   *
+   * @param entries Range of `std::pair<Key, Value>`-like items
+   */
+  template <typename Range>
+  explicit lookup_table(const Range& entries)
+    :_state(std::make_shared<state>(build(entries)))
+  {}
+
+  /**
+   * Replaces the entries of the table by `entries`.
+   *
+   * The new table is built before the swap, readers are not blocked.
+   *
+   * @param entries Range of `std::pair<Key, Value>`-like items
+   */
+  template <typename Range>
+  void reset(const Range& entries)
+  {
+    std::atomic_store(&_state->table, build(entries));
+    _state->version.fetch_add(1, std::memory_order_release);
+  }
+
+  /** @returns The current table, valid even if the table is `reset()` */
+  std::shared_ptr<const table_type> snapshot() const
+  {
+    return std::atomic_load(&_state->table);
+  }
+
+private:
+  template <typename Range>
+  static std::shared_ptr<const table_type> build(const Range& entries)
+  {
+    auto table = std::make_shared<table_type>();
+
+    for (const auto& entry : entries)
+    {
+      *table->insert(entry.first, entry.second).first = entry.second;
+    }
+
+    return table;
+  }
+
+  std::shared_ptr<state> _state; /**< shared among copies */
+};
+
+namespace detail {
+
+template <typename Key, typename Value, typename KeyFn, typename MergeFn>
+class enrich_stage
+{
+public:
+  template <typename Input>
+  using result_type = typename std::decay<decltype(
+    std::declval<const MergeFn&>()(std::declval<const Input&>(), std::declval<const Value*>())
+  )>::type;
+
+  template <typename Plan>
+  using connect_type = one_one_segment<Plan, result_type<typename Plan::value_type>>;
+
+  enrich_stage(
+    const lookup_table<Key, Value>& table,
+    const KeyFn& key_fn,
+    const MergeFn& merge_fn
+  )
+    :_table(table),
+     _key_fn(key_fn),
+     _merge_fn(merge_fn)
+  {}
+
+  template <typename T>
+  result_type<T> operator()(const T& item) const
+  {
+    return _merge_fn(item, _table.get().find(_key_fn(item)));
+  }
+
+private:
+  // each task runs its own copy of the stage, therefore
+  // the snapshot is kept per replica, refreshed on reset()
+  mutable typename lookup_table<Key, Value>::reader _table;
+  KeyFn _key_fn;
+  MergeFn _merge_fn;
+};
+
+} // namespace detail
+
+/**
+ * Creates a 1-1 transformation which looks up
+ * the value of each item in `table` and merges them.
+ *
+ * The table is shared, not copied: calling `reset()` on `table`
+ * swaps the looked up entries without stopping the pipeline.
+ * The stage keeps a snapshot of the table, which is refreshed
+ * at the next item after a `reset()`.
+ *
+ * @code
+ * lookup_table<int, std::string> department_names(departments);
+ *
+ * auto exec = (from(persons) | enrich(
+ *   department_names,
+ *   [](const person& p) { return p.department_id; },
+ *   [](const person& p, const std::string* name) { return relation{name ? *name : "", p.name}; }
+ * ) | output).run(pool);
+ *
+ * department_names.reset(updated_departments);
+ * @endcode
+ *
+ * @param table Table of the looked up values
+ * @param key_fn Key of an item, `K key_fn(const T&)`
+ * @param merge_fn Produces the output, `R merge_fn(const T&, const V*)`,
+ *                 the second argument is nullptr if the key is not found
+ * @returns A transformation of `T` items to `R` items
+ */
+template <typename Key, typename Value, typename KeyFn, typename MergeFn>
+detail::enrich_stage<Key, Value, KeyFn, MergeFn>
+enrich(const lookup_table<Key, Value>& table, KeyFn key_fn, MergeFn merge_fn)
+{
+  return detail::enrich_stage<Key, Value, KeyFn, MergeFn>(table, key_fn, merge_fn);
+}
+
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_ENRICH_HPP
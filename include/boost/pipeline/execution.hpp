@@ -15,6 +15,8 @@
 
 #include <future>
 #include <chrono>
+#include <vector>
+#include <memory>
 
 #include <boost/pipeline/queue.hpp>
 #include <boost/pipeline/threading.hpp>
@@ -31,6 +33,9 @@ namespace pipeline {
  * Holds a future which is set on pipeline completition,
  * destructor blocks until pipeline is terminated.
  * `std::move` it if it's not desired.
+ *
+ * If a sink fails, the future holds its exception,
+ * which is rethrown by `wait()`.
  */
 class execution
 {
@@ -42,8 +47,26 @@ public:
    * of the represented pipeline.
    */
   execution(std::future<void>&& future)
-    :_future(std::move(future))
-  {}
+  {
+    _futures.push_back(future.share());
+  }
+
+  /**
+   * Creates an execution representing several
+   * executions, e.g: the branches of a pipeline.
+   *
+   * @param parts Executions to be represented, taken over by this instance
+   */
+  execution(std::vector<execution>&& parts)
+  {
+    for (execution& part : parts)
+    {
+      for (std::shared_future<void>& future : part._futures)
+      {
+        _futures.push_back(std::move(future));
+      }
+    }
+  }
 
   /**
    * Checks if the pipeline has terminated
@@ -52,18 +75,75 @@ public:
    */
   bool is_done()
   {
-    return _future.wait_for(std::chrono::microseconds(1)) == std::future_status::ready;
+    for (std::shared_future<void>& future : _futures)
+    {
+      if (future.wait_for(std::chrono::microseconds(1)) != std::future_status::ready)
+      {
+        return false;
+      }
+    }
+
+    return true;
   }
 
   /**
    * Waits until the execution of the pipeline is completed
    *
    * @post Blocks until the execution is done
+   * @throws The exception a segment of the pipeline failed with, if any
+   */
+  void wait()
+  {
+    for (std::shared_future<void>& future : _futures)
+    {
+      future.wait();
+    }
+
+    // each part is done, report the first failure
+    for (std::shared_future<void>& future : _futures)
+    {
+      future.get();
+    }
+  }
+
+private:
+  std::vector<std::shared_future<void>> _futures;
+};
+
+/**
+ * Handle to an executing pipeline which computes a result,
+ * e.g: a summary of the processed items.
+ *
+ * Returned by `run()` of pipelines terminated by a summarizing segment.
+ */
+template <typename Result>
+class summary_execution : public execution
+{
+public:
+  /**
+   * @param future Future promised by the terminating segment
+   * @param result Result computed by the terminating segment,
+   *               complete if `future` is ready
    */
-  void wait()    { _future.wait(); }
+  summary_execution(std::future<void>&& future, const std::shared_ptr<Result>& result)
+    :execution(std::move(future)),
+     _result(result)
+  {}
+
+  /**
+   * Waits until the execution of the pipeline is completed
+   *
+   * @returns The computed result
+   * @throws The exception a segment of the pipeline failed with, if any
+   */
+  Result& get()
+  {
+    wait();
+    return *_result;
+  }
 
 private:
-  std::future<void> _future;
+  std::shared_ptr<Result> _result;
 };
 
 } // namespace pipeline
@@ -0,0 +1,241 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_FAN_IN_HPP
+#define BOOST_PIPELINE_FAN_IN_HPP
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cstddef>
+#include <type_traits>
+
+#include <boost/pipeline/queue.hpp>
+#include <boost/pipeline/threading.hpp>
+#include <boost/pipeline/type_erasure.hpp>
+#include <boost/pipeline/detail/segment.hpp>
+#include <boost/pipeline/detail/batched_reader.hpp>
+
+namespace boost {
+namespace pipeline {
+
+namespace detail {
+
+template <typename Output>
+class merge_segment : public segment_concept<terminated, Output>
+{
+public:
+  typedef void root_type;
+  typedef Output value_type;
+
+  merge_segment(const std::vector<segment<terminated, Output>>& inputs)
+    :_inputs(inputs)
+  {}
+
+  void run(thread_pool& pool, const queue_back<value_type>& target)
+  {
+    auto producers = target.split(_inputs.size());
+
+    for (std::size_t i = 0; i < _inputs.size(); ++i)
+    {
+      _inputs[i].run(pool, producers[i]);
+    }
+  }
+
+  std::unique_ptr<segment_concept<terminated, value_type>> clone() const
+  {
+    return std::unique_ptr<segment_concept<terminated, value_type>>(
+      new merge_segment<Output>(*this)
+    );
+  }
+
+private:
+  std::vector<segment<terminated, Output>> _inputs;
+};
+
+template <typename O>
+struct is_connectable_segment<merge_segment<O>> : public std::true_type {};
+
+template <typename Output>
+inline void append_inputs(std::vector<segment<terminated, Output>>&) {}
+
+template <typename Output, typename Input, typename... Inputs>
+void append_inputs(
+  std::vector<segment<terminated, Output>>& segments,
+  const Input& input,
+  const Inputs&... inputs
+)
+{
+  static_assert(
+    std::is_same<Output, typename Input::value_type>::value,
+    "Merged segments must produce the same type of items"
+  );
+
+  segments.push_back(segment<terminated, Output>(input));
+  append_inputs(segments, inputs...);
+}
+
+template <typename First, typename Second>
+class zip_task
+{
+  static const std::size_t batch_size = 64;
+
+public:
+  typedef std::pair<First, Second> output_type;
+
+  zip_task(const queue_back<output_type>& downstream)
+    :_first(std::make_shared<queue<First>>()),
+     _second(std::make_shared<queue<Second>>()),
+     _downstream(downstream)
+  {}
+
+  void operator()()
+  {
+    batched_reader<First> first(*_first, batch_size);
+    batched_reader<Second> second(*_second, batch_size);
+
+    while (! _downstream.is_cancelled() && first.has_front() && second.has_front())
+    {
+      _downstream.push(output_type(std::move(first.front()), std::move(second.front())));
+
+      first.pop();
+      second.pop();
+    }
+
+    // an exhausted input might have failed
+    _downstream.close(_first->error() ? _first->error() : _second->error());
+
+    // the remaining items are not needed
+    first.cancel();
+    second.cancel();
+  }
+
+  queue_back<First> get_first_queue_back()
+  {
+    return queue_back<First>(_first);
+  }
+
+  queue_back<Second> get_second_queue_back()
+  {
+    return queue_back<Second>(_second);
+  }
+
+private:
+  std::shared_ptr<queue<First>> _first;
+  std::shared_ptr<queue<Second>> _second;
+  queue_back<output_type> _downstream;
+};
+
+template <typename First, typename Second>
+class zip_segment
+  : public segment_concept<terminated, std::pair<First, Second>>
+{
+public:
+  typedef void root_type;
+  typedef std::pair<First, Second> value_type;
+
+  typedef zip_task<First, Second> task_type;
+
+  zip_segment(
+    const segment<terminated, First>& first,
+    const segment<terminated, Second>& second
+  )
+    :_first(first),
+     _second(second)
+  {}
+
+  void run(thread_pool& pool, const queue_back<value_type>& target)
+  {
+    task_type task(target);
+
+    _first.run(pool, task.get_first_queue_back());
+    _second.run(pool, task.get_second_queue_back());
+
+    pool.submit(std::move(task));
+  }
+
+  std::unique_ptr<segment_concept<terminated, value_type>> clone() const
+  {
+    return std::unique_ptr<segment_concept<terminated, value_type>>(
+      new zip_segment<First, Second>(*this)
+    );
+  }
+
+private:
+  segment<terminated, First> _first;
+  segment<terminated, Second> _second;
+};
+
+template <typename F, typename S>
+struct is_connectable_segment<zip_segment<F, S>> : public std::true_type {};
+
+} // namespace detail
+
+/**
+ * Creates a left-terminated segment which pairs the
+ * items of `first` and `second` element-wise.
+ *
+ * The n-th output is an `std::pair` of the n-th item of `first`
+ * and the n-th item of `second`. The inputs are read in batches,
+ * in lock-step. The output is closed if either of the inputs
+ * is exhausted, then the other input is cancelled.
+ *
+ * @code
+ * auto exec = (zip(from(features), from(labels)) | train).run(pool);
+ * @endcode
+ *
+ * @param first Left-terminated segment producing `A` items
+ * @param second Left-terminated segment producing `B` items
+ * @returns `segment<terminated, std::pair<A, B>>`
+ */
+template <typename First, typename Second>
+detail::zip_segment<typename First::value_type, typename Second::value_type>
+zip(const First& first, const Second& second)
+{
+  return detail::zip_segment<typename First::value_type, typename Second::value_type>(
+    first, second
+  );
+}
+
+/**
+ * Creates a left-terminated segment which
+ * produces the items of each of `inputs`.
+ *
+ * Items of the same input keep their order,
+ * but items of different inputs are interleaved as they arrive.
+ * The inputs push their items directly to the downstream queue,
+ * which is closed if every input is exhausted.
+ *
+ * @code
+ * auto exec = (merge(from(local_events), from(remote_events)) | process).run(pool);
+ * @endcode
+ *
+ * @param input First left-terminated segment producing `T` items
+ * @param inputs Further left-terminated segments producing `T` items
+ * @returns `segment<terminated, T>`
+ */
+template <typename Input, typename... Inputs>
+detail::merge_segment<typename Input::value_type>
+merge(const Input& input, const Inputs&... inputs)
+{
+  typedef typename Input::value_type output;
+
+  std::vector<segment<terminated, output>> segments;
+  detail::append_inputs(segments, input, inputs...);
+
+  return detail::merge_segment<output>(segments);
+}
+
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_FAN_IN_HPP
@@ -0,0 +1,628 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_FAN_OUT_HPP
+#define BOOST_PIPELINE_FAN_OUT_HPP
+
+#include <tuple>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+#include <boost/assert.hpp>
+
+#include <boost/pipeline/queue.hpp>
+#include <boost/pipeline/execution.hpp>
+#include <boost/pipeline/threading.hpp>
+#include <boost/pipeline/type_erasure.hpp>
+#include <boost/pipeline/detail/segment.hpp>
+
+namespace boost {
+namespace pipeline {
+
+namespace detail {
+
+/**
+ * Bounded ring buffer, each item is read by every consumer.
+ *
+ * Items are stored once, each consumer has its own read cursor.
+ * A slot is reused only if every consumer has read it, therefore
+ * the slowest consumer blocks the producer if the buffer is full.
+ * Consumers receive a copy of the items, except the last one
+ * reading a given item, which takes it. A consumer not needing
+ * more items detaches, releasing the slots it didn't read.
+ */
+template <typename T>
+class broadcast_buffer
+{
+  struct slot
+  {
+    T value;
+    std::size_t readers = 0;
+  };
+
+public:
+  broadcast_buffer(std::size_t capacity, std::size_t consumers)
+    :_slots(capacity),
+     _cursors(consumers, 0),
+     _attached(consumers),
+     _head(0),
+     _tail(0),
+     _closed(false)
+  {}
+
+  /**
+   * Blocks while the buffer is full.
+   *
+   * @returns true, if the item is pushed, false if every consumer is detached
+   */
+  bool push(T&& item)
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _not_full.wait(lock, [this]
+    {
+      return _head - _tail < _slots.size() || _attached == 0;
+    });
+
+    if (_attached == 0) { return false; }
+
+    slot& s = _slots[_head % _slots.size()];
+    s.value = std::move(item);
+    s.readers = _attached;
+    ++_head;
+
+    _not_empty.notify_all();
+    return true;
+  }
+
+  /**
+   * Reads the next item of `consumer`.
+   *
+   * Blocks until an item is available or the buffer gets closed.
+   *
+   * @returns true, if an item is read, false if the buffer is closed and exhausted
+   */
+  bool pull(std::size_t consumer, T& ret)
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    std::uint64_t& cursor = _cursors[consumer];
+    _not_empty.wait(lock, [&] { return cursor < _head || _closed; });
+
+    if (cursor == _head) { return false; }
+
+    slot& s = _slots[cursor % _slots.size()];
+    const bool is_last = (s.readers == 1);
+
+    // the slot is not reused until released below
+    lock.unlock();
+    ret = (is_last) ? std::move(s.value) : s.value;
+    lock.lock();
+
+    ++cursor;
+
+    if (--s.readers == 0) { release(); }
+
+    return true;
+  }
+
+  /** Stops delivering items to `consumer`, releases its unread items */
+  void detach(std::size_t consumer)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::uint64_t& cursor = _cursors[consumer];
+    for (; cursor < _head; ++cursor)
+    {
+      --_slots[cursor % _slots.size()].readers;
+    }
+
+    --_attached;
+
+    release();
+  }
+
+  /** @param error The error the producer failed with, if any */
+  void close(const std::exception_ptr& error)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _closed = true;
+    _error = error;
+    _not_empty.notify_all();
+  }
+
+  /** @returns The error the buffer is closed with, if any */
+  std::exception_ptr error()
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _error;
+  }
+
+private:
+  /** Reuses the leading slots read by every consumer, the lock must be held */
+  void release()
+  {
+    while (_tail < _head && _slots[_tail % _slots.size()].readers == 0)
+    {
+      ++_tail;
+    }
+
+    _not_full.notify_one();
+  }
+
+  std::mutex _mutex;
+  std::condition_variable _not_full;
+  std::condition_variable _not_empty;
+
+  std::vector<slot> _slots;
+  std::vector<std::uint64_t> _cursors;
+  std::size_t _attached; /**< number of consumers not detached */
+  std::uint64_t _head; /**< sequence number of the next item to be pushed */
+  std::uint64_t _tail; /**< sequence number of the oldest unreleased item */
+  bool _closed;
+  std::exception_ptr _error;
+};
+
+template <typename T>
+class broadcast_writer_task
+{
+public:
+  broadcast_writer_task(const std::shared_ptr<broadcast_buffer<T>>& buffer)
+    :_input(std::make_shared<queue<T>>()),
+     _buffer(buffer)
+  {}
+
+  void operator()()
+  {
+    queue_front<T> upstream(*_input);
+
+    T item;
+    while (upstream.wait_pull(item))
+    {
+      // every branch is cancelled
+      if (! _buffer->push(std::move(item))) { upstream.cancel(); break; }
+    }
+
+    _buffer->close(upstream.error());
+  }
+
+  queue_back<T> get_queue_back()
+  {
+    return queue_back<T>(_input);
+  }
+
+private:
+  std::shared_ptr<queue<T>> _input;
+  std::shared_ptr<broadcast_buffer<T>> _buffer;
+};
+
+template <typename T>
+class broadcast_reader_task
+{
+public:
+  broadcast_reader_task(
+    const std::shared_ptr<broadcast_buffer<T>>& buffer,
+    std::size_t consumer,
+    std::size_t max_backlog,
+    const queue_back<T>& downstream
+  )
+    :_buffer(buffer),
+     _consumer(consumer),
+     _max_backlog(max_backlog),
+     _downstream(downstream)
+  {}
+
+  void operator()()
+  {
+    T item;
+
+    while (true)
+    {
+      // keep the items in the shared buffer
+      // while the downstream is lagging behind
+      auto backoff = std::chrono::microseconds(20);
+      while (_downstream.size() >= _max_backlog && ! _downstream.is_cancelled())
+      {
+        std::this_thread::sleep_for(backoff);
+        backoff = std::min(backoff * 2, std::chrono::microseconds(1000));
+      }
+
+      if (_downstream.is_cancelled())
+      {
+        _buffer->detach(_consumer);
+        break;
+      }
+
+      if (! _buffer->pull(_consumer, item)) { break; }
+
+      _downstream.push(std::move(item));
+    }
+
+    _downstream.close(_buffer->error());
+  }
+
+private:
+  std::shared_ptr<broadcast_buffer<T>> _buffer;
+  std::size_t _consumer;
+  std::size_t _max_backlog;
+  queue_back<T> _downstream;
+};
+
+/** Feeds a branch of a tee from the shared buffer */
+template <typename T>
+class broadcast_source : public runnable_concept<T>
+{
+public:
+  broadcast_source(
+    const std::shared_ptr<broadcast_buffer<T>>& buffer,
+    std::size_t consumer,
+    std::size_t max_backlog
+  )
+    :_buffer(buffer),
+     _consumer(consumer),
+     _max_backlog(max_backlog)
+  {}
+
+  void run(thread_pool& pool, const queue_back<T>& target)
+  {
+    pool.submit(broadcast_reader_task<T>(_buffer, _consumer, _max_backlog, target));
+  }
+
+private:
+  std::shared_ptr<broadcast_buffer<T>> _buffer;
+  std::size_t _consumer;
+  std::size_t _max_backlog;
+};
+
+/** Converts each element of a tuple to `segment<Input, terminated>` */
+template <typename Input, std::size_t N>
+struct append_branches
+{
+  template <typename Tuple>
+  static void apply(const Tuple& tuple, std::vector<segment<Input, terminated>>& branches)
+  {
+    append_branches<Input, N-1>::apply(tuple, branches);
+    branches.push_back(segment<Input, terminated>(std::get<N-1>(tuple)));
+  }
+};
+
+template <typename Input>
+struct append_branches<Input, 0>
+{
+  template <typename Tuple>
+  static void apply(const Tuple&, std::vector<segment<Input, terminated>>&) {}
+};
+
+template <typename Parent>
+class tee_segment : public basic_segment<Parent, terminated>
+{
+  typedef basic_segment<Parent, terminated> base_segment;
+
+public:
+  typedef typename base_segment::root_type  root_type;
+  typedef typename base_segment::input_type input_type;
+  typedef typename base_segment::value_type value_type;
+
+  typedef broadcast_buffer<input_type> buffer_type;
+
+  template <typename Stage>
+  tee_segment(const Parent& parent, const Stage& stage)
+    :base_segment(parent),
+     _capacity(stage.capacity),
+     _max_backlog(stage.max_backlog)
+  {
+    typedef typename Stage::tuple_type tuple_type;
+    append_branches<input_type, std::tuple_size<tuple_type>::value>
+      ::apply(stage.branches, _branches);
+  }
+
+  execution run(thread_pool& pool)
+  {
+    auto buffer = std::make_shared<buffer_type>(_capacity, _branches.size());
+
+    broadcast_writer_task<input_type> task(buffer);
+    base_segment::_parent.run(pool, task.get_queue_back());
+
+    std::vector<execution> executions;
+
+    for (std::size_t i = 0; i < _branches.size(); ++i)
+    {
+      broadcast_source<input_type> source(buffer, i, _max_backlog);
+
+      segment<input_type, terminated> branch(_branches[i]);
+      connect_to(branch, source);
+      executions.push_back(branch.run(pool));
+    }
+
+    pool.submit(std::move(task));
+
+    return execution(std::move(executions));
+  }
+
+  std::unique_ptr<segment_concept<root_type, terminated>> clone() const
+  {
+    return std::unique_ptr<segment_concept<root_type, terminated>>(
+      new tee_segment<Parent>(*this)
+    );
+  }
+
+private:
+  std::vector<segment<input_type, terminated>> _branches;
+  std::size_t _capacity;
+  std::size_t _max_backlog;
+};
+
+template <typename... Branches>
+struct tee_stage
+{
+  typedef std::tuple<Branches...> tuple_type;
+
+  template <typename Plan>
+  using connect_type = tee_segment<Plan>;
+
+  tuple_type branches;
+  std::size_t capacity;
+  std::size_t max_backlog;
+};
+
+template <typename T, typename Selector>
+class route_task
+{
+public:
+  route_task(const Selector& selector)
+    :_input(std::make_shared<queue<T>>()),
+     _branches(new std::vector<queue_back<T>>()),
+     _selector(selector)
+  {}
+
+  void operator()()
+  {
+    queue_front<T> upstream(*_input);
+    std::vector<queue_back<T>>& branches = *_branches;
+
+    std::exception_ptr error;
+
+    try
+    {
+      T item;
+      while (upstream.wait_pull(item))
+      {
+        const std::size_t index = static_cast<std::size_t>(_selector(item));
+
+        BOOST_ASSERT(index < branches.size());
+        if (index >= branches.size())
+        {
+          throw std::out_of_range("route() selector returned an out of range index");
+        }
+
+        if (branches[index].is_cancelled())
+        {
+          if (all_cancelled()) { upstream.cancel(); break; }
+          continue;
+        }
+
+        branches[index].push(std::move(item));
+      }
+
+      error = upstream.error();
+    }
+    catch (...)
+    {
+      // reported by execution::wait(), the items are not needed anymore
+      upstream.cancel();
+      error = std::current_exception();
+    }
+
+    for (queue_back<T>& branch : branches)
+    {
+      branch.close(error);
+    }
+  }
+
+  queue_back<T> get_queue_back()
+  {
+    return queue_back<T>(_input);
+  }
+
+  /** Branches in the order of their registration */
+  std::vector<queue_back<T>>& branches()
+  {
+    return *_branches;
+  }
+
+private:
+  bool all_cancelled() const
+  {
+    for (const queue_back<T>& branch : *_branches)
+    {
+      if (! branch.is_cancelled()) { return false; }
+    }
+
+    return true;
+  }
+
+  std::shared_ptr<queue<T>> _input;
+  std::unique_ptr<std::vector<queue_back<T>>> _branches;
+  Selector _selector;
+};
+
+/** Registers the input queue of a branch in a router */
+template <typename T>
+class route_source : public runnable_concept<T>
+{
+public:
+  route_source(std::vector<queue_back<T>>& targets)
+    :_targets(targets)
+  {}
+
+  void run(thread_pool&, const queue_back<T>& target)
+  {
+    _targets.push_back(target);
+  }
+
+private:
+  std::vector<queue_back<T>>& _targets;
+};
+
+template <typename Parent, typename Selector>
+class route_segment : public basic_segment<Parent, terminated>
+{
+  typedef basic_segment<Parent, terminated> base_segment;
+
+public:
+  typedef typename base_segment::root_type  root_type;
+  typedef typename base_segment::input_type input_type;
+  typedef typename base_segment::value_type value_type;
+
+  typedef route_task<input_type, Selector> task_type;
+
+  template <typename Stage>
+  route_segment(const Parent& parent, const Stage& stage)
+    :base_segment(parent),
+     _selector(stage.selector)
+  {
+    typedef typename Stage::tuple_type tuple_type;
+    append_branches<input_type, std::tuple_size<tuple_type>::value>
+      ::apply(stage.branches, _branches);
+  }
+
+  execution run(thread_pool& pool)
+  {
+    task_type task(_selector);
+    base_segment::_parent.run(pool, task.get_queue_back());
+
+    std::vector<execution> executions;
+    route_source<input_type> source(task.branches());
+
+    for (const segment<input_type, terminated>& branch_prototype : _branches)
+    {
+      segment<input_type, terminated> branch(branch_prototype);
+      connect_to(branch, source);
+      executions.push_back(branch.run(pool));
+    }
+
+    pool.submit(std::move(task));
+
+    return execution(std::move(executions));
+  }
+
+  std::unique_ptr<segment_concept<root_type, terminated>> clone() const
+  {
+    return std::unique_ptr<segment_concept<root_type, terminated>>(
+      new route_segment<Parent, Selector>(*this)
+    );
+  }
+
+private:
+  std::vector<segment<input_type, terminated>> _branches;
+  Selector _selector;
+};
+
+template <typename Selector, typename... Branches>
+struct route_stage
+{
+  typedef std::tuple<Branches...> tuple_type;
+
+  template <typename Plan>
+  using connect_type = route_segment<Plan, Selector>;
+
+  Selector selector;
+  tuple_type branches;
+};
+
+} // namespace detail
+
+/**
+ * Creates a right-terminated segment which feeds each of
+ * its input items to exactly one of `branches`.
+ *
+ * Each item `i` is pushed to the branch indexed by `selector(i)`.
+ * Each branch is a right-terminated segment (see `tee()`) and has its own
+ * input queue, written by the router only. The input queues of the
+ * branches are closed if the upstream is exhausted.
+ *
+ * The returned `execution` is done if every branch is done:
+ *
+ * @code
+ * auto by_priority = [](const request& r) -> std::size_t { return r.is_priority ? 0 : 1; };
+ * auto exec = (from(requests) | route(by_priority, make(serve), make(serve_later))).run(pool);
+ * @endcode
+ *
+ * @param selector Index of the target branch of an item, `std::size_t selector(const T&)`,
+ *                 must be less than the number of branches. If asserts are disabled,
+ *                 an out of range index stops the routing and `execution::wait()`
+ *                 throws `std::out_of_range`
+ * @param branches Right-terminated segments consuming the upstream items, at least one
+ * @returns `segment<T, terminated>`
+ */
+template <typename Selector, typename... Branches>
+detail::route_stage<Selector, Branches...>
+route(Selector selector, const Branches&... branches)
+{
+  static_assert(sizeof...(Branches) > 0, "route() requires at least one branch");
+
+  return detail::route_stage<Selector, Branches...>{
+    selector,
+    std::make_tuple(branches...)
+  };
+}
+
+/**
+ * Creates a right-terminated segment which feeds each of
+ * its input items to every one of `branches`.
+ *
+ * Each branch must be a right-terminated segment,
+ * accepting the output of the upstream segment, e.g:
+ * `segment<T, terminated>`, `make(f) | sink` or `to(f)`.
+ *
+ * Items are buffered in a bounded ring buffer shared by the branches,
+ * each branch reads it using its own cursor. The items are not shared
+ * by the branches: each branch receives a copy of each item in its input
+ * queue, except the last reader, which takes it. While 64 items are
+ * waiting in the input queue of a branch, its reader polls the queue,
+ * sleeping for increasing intervals, up to a millisecond. The slowest branch
+ * determines the pace of the upstream, once the ring buffer is full.
+ *
+ * The returned `execution` is done if every branch is done:
+ *
+ * @code
+ * auto exec = (from(input) | tee(make(parse) | store, make(count) | report)).run(pool);
+ * @endcode
+ *
+ * @param branches Right-terminated segments consuming the upstream items, at least one
+ * @returns `segment<T, terminated>`
+ */
+template <typename... Branches>
+detail::tee_stage<Branches...> tee(const Branches&... branches)
+{
+  // without readers, the slots of the buffer would never be released
+  static_assert(sizeof...(Branches) > 0, "tee() requires at least one branch");
+
+  return detail::tee_stage<Branches...>{
+    std::make_tuple(branches...),
+    1024, // ring buffer capacity
+    64    // max number of items waiting in the input queue of a branch
+  };
+}
+
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_FAN_OUT_HPP
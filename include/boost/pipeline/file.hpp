@@ -0,0 +1,474 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_FILE_HPP
+#define BOOST_PIPELINE_FILE_HPP
+
+#include <cerrno>
+#include <string>
+#include <future>
+#include <memory>
+#include <cstring>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <boost/utility/string_ref.hpp>
+
+#include <boost/pipeline/queue.hpp>
+#include <boost/pipeline/detail/segment.hpp>
+
+namespace boost {
+namespace pipeline {
+
+/**
+ * Read-only memory mapping of a file.
+ *
+ * The mapping is released when the object is destroyed,
+ * therefore it must outlive every reference to its content.
+ */
+class mapped_file
+{
+public:
+  /**
+   * Maps the file at `path`
+   *
+   * @param path Path of the file to map
+   * @throws `std::runtime_error` If the file can't be opened or mapped
+   */
+  explicit mapped_file(const std::string& path)
+    :_data(nullptr),
+     _size(0)
+  {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+      throw std::runtime_error("Failed to open file: " + path);
+    }
+
+    struct stat status;
+    if (::fstat(fd, &status) != 0)
+    {
+      ::close(fd);
+      throw std::runtime_error("Failed to stat file: " + path);
+    }
+
+    _size = static_cast<std::size_t>(status.st_size);
+
+    // empty files can't be mapped
+    if (_size > 0)
+    {
+      void* data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED)
+      {
+        ::close(fd);
+        throw std::runtime_error("Failed to map file: " + path);
+      }
+
+      ::madvise(data, _size, MADV_SEQUENTIAL);
+      _data = static_cast<const char*>(data);
+    }
+
+    // the mapping remains valid
+    ::close(fd);
+  }
+
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  ~mapped_file()
+  {
+    if (_data) { ::munmap(const_cast<char*>(_data), _size); }
+  }
+
+  const char* data() const { return _data; }
+  std::size_t size() const { return _size; }
+
+private:
+  const char* _data;
+  std::size_t _size;
+};
+
+namespace detail {
+
+/**
+ * Iterates over the '\n' separated lines of a buffer,
+ * the separators are not included.
+ *
+ * A trailing separator doesn't start a new line.
+ */
+class line_iterator
+{
+public:
+  typedef std::input_iterator_tag iterator_category;
+  typedef boost::string_ref value_type;
+  typedef std::ptrdiff_t difference_type;
+  typedef const boost::string_ref* pointer;
+  typedef boost::string_ref reference;
+
+  line_iterator(const char* begin, const char* end)
+    :_current(begin),
+     _end(end)
+  {
+    find_line_end();
+  }
+
+  boost::string_ref operator*() const
+  {
+    return boost::string_ref(_current, static_cast<std::size_t>(_line_end - _current));
+  }
+
+  line_iterator& operator++()
+  {
+    _current = (_line_end == _end) ? _end : _line_end + 1;
+    find_line_end();
+    return *this;
+  }
+
+  bool operator==(const line_iterator& rhs) const { return _current == rhs._current; }
+  bool operator!=(const line_iterator& rhs) const { return _current != rhs._current; }
+
+private:
+  void find_line_end()
+  {
+    // memchr is vectorized by the common C libraries
+    const void* found = (_current == _end)
+      ? nullptr
+      : std::memchr(_current, '\n', static_cast<std::size_t>(_end - _current));
+
+    _line_end = (found) ? static_cast<const char*>(found) : _end;
+  }
+
+  const char* _current;
+  const char* _end;
+  const char* _line_end;
+};
+
+} // namespace detail
+
+/**
+ * Creates a segment operating on the lines of a mapped file.
+ *
+ * Lines are emitted as `boost::string_ref` items referring to
+ * the mapping, without copying or allocation. The '\n' separators
+ * are not included. As with containers passed to `from()`,
+ * `file` must outlive the execution and each emitted item:
+ *
+ * @code
+ * mapped_file log("access.log");
+ * auto exec = (from_file_lines(log) | parse_entry | output).run(pool);
+ * exec.wait();
+ * @endcode
+ *
+ * @param file Mapped file to read
+ * @returns `segment<terminated, boost::string_ref>`
+ */
+inline detail::range_input_segment<detail::line_iterator>
+from_file_lines(const mapped_file& file)
+{
+  const char* begin = file.data();
+  const char* end = begin + file.size();
+
+  return detail::range_input_segment<detail::line_iterator>(
+    detail::line_iterator(begin, end),
+    detail::line_iterator(end, end)
+  );
+}
+
+/** When the file sinks call `fsync()` on the written file */
+enum class sync_policy
+{
+  none,     /**< never, the data is left to the operating system */
+  on_close, /**< once, after the last item is written */
+  on_flush  /**< after each buffer written */
+};
+
+/**
+ * Default item format of the file sinks:
+ * each item is written on its own line.
+ *
+ * Strings are written as they are, arithmetic types
+ * are converted by `std::to_string()`.
+ */
+struct line_format
+{
+  void operator()(const std::string& item, std::string& buffer) const
+  {
+    buffer.append(item);
+    buffer.push_back('\n');
+  }
+
+  void operator()(const boost::string_ref& item, std::string& buffer) const
+  {
+    buffer.append(item.data(), item.size());
+    buffer.push_back('\n');
+  }
+
+  template <typename T>
+  typename std::enable_if<std::is_arithmetic<T>::value>::type
+  operator()(const T& item, std::string& buffer) const
+  {
+    buffer.append(std::to_string(item));
+    buffer.push_back('\n');
+  }
+};
+
+namespace detail {
+
+/** File descriptor, closed on destruction if owned */
+class file_descriptor
+{
+public:
+  file_descriptor(int fd, bool owned)
+    :_fd(fd),
+     _owned(owned)
+  {}
+
+  file_descriptor(const file_descriptor&) = delete;
+  file_descriptor& operator=(const file_descriptor&) = delete;
+
+  ~file_descriptor()
+  {
+    if (_owned) { ::close(_fd); }
+  }
+
+  int get() const { return _fd; }
+
+private:
+  int _fd;
+  bool _owned;
+};
+
+/**
+ * Writes `size` bytes of `data` to `fd`, retrying partial writes
+ *
+ * @throws `std::runtime_error` If the write fails
+ */
+inline void write_all(int fd, const char* data, std::size_t size)
+{
+  while (size > 0)
+  {
+    const ssize_t written = ::write(fd, data, size);
+    if (written < 0)
+    {
+      if (errno == EINTR) { continue; }
+      throw std::runtime_error(std::string("Failed to write file: ") + std::strerror(errno));
+    }
+
+    data += written;
+    size -= static_cast<std::size_t>(written);
+  }
+}
+
+/**
+ * Double buffered writer: while a full buffer is written
+ * in the background, items are formatted into the other one.
+ */
+class buffered_writer
+{
+public:
+  buffered_writer(int fd, std::size_t buffer_size, sync_policy sync)
+    :_fd(fd),
+     _buffer_size(buffer_size),
+     _sync(sync)
+  {
+    _filling.reserve(buffer_size);
+    _writing.reserve(buffer_size);
+  }
+
+  ~buffered_writer()
+  {
+    // the background write refers to `_writing`
+    if (_pending.valid()) { _pending.wait(); }
+  }
+
+  std::string& buffer() { return _filling; }
+
+  /** Starts writing the buffer if it is full */
+  void flush_if_full()
+  {
+    if (_filling.size() >= _buffer_size) { flush(); }
+  }
+
+  /** Writes the remaining items and waits for the pending write */
+  void finish()
+  {
+    if (! _filling.empty()) { flush(); }
+    if (_pending.valid()) { _pending.get(); }
+
+    if (_sync == sync_policy::on_close) { sync(_fd); }
+  }
+
+private:
+  void flush()
+  {
+    // rethrows the error of the previous write
+    if (_pending.valid()) { _pending.get(); }
+
+    std::swap(_filling, _writing);
+    _filling.clear();
+
+    const int fd = _fd;
+    const bool sync_each = (_sync == sync_policy::on_flush);
+    const std::string& data = _writing;
+
+    _pending = std::async(std::launch::async, [fd, sync_each, &data]()
+    {
+      write_all(fd, data.data(), data.size());
+      if (sync_each) { sync(fd); }
+    });
+  }
+
+  static void sync(int fd)
+  {
+    if (::fsync(fd) != 0)
+    {
+      throw std::runtime_error(std::string("Failed to sync file: ") + std::strerror(errno));
+    }
+  }
+
+  int _fd;
+  std::size_t _buffer_size;
+  sync_policy _sync;
+  std::string _filling;
+  std::string _writing;
+  std::future<void> _pending;
+};
+
+template <typename Format>
+class file_sink_stage
+{
+public:
+  template <typename Plan>
+  using connect_type = n_one_segment<Plan, void>;
+
+  file_sink_stage(
+    const std::shared_ptr<file_descriptor>& file,
+    const Format& format,
+    std::size_t buffer_size,
+    sync_policy sync
+  )
+    :_file(file),
+     _format(format),
+     _buffer_size(std::max<std::size_t>(1, buffer_size)),
+     _sync(sync)
+  {}
+
+  template <typename T>
+  void operator()(queue_front<T>& upstream) const
+  {
+    // whole-stream sink, see pull_or_cancel: there is no downstream to watch,
+    // errors are reported by the sink task, which cancels the upstream
+    buffered_writer writer(_file->get(), _buffer_size, _sync);
+
+    T item;
+    while (upstream.wait_pull(item))
+    {
+      _format(item, writer.buffer());
+      writer.flush_if_full();
+    }
+
+    writer.finish();
+  }
+
+private:
+  std::shared_ptr<file_descriptor> _file; /**< shared among copies */
+  Format _format;
+  std::size_t _buffer_size;
+  sync_policy _sync;
+};
+
+} // namespace detail
+
+/**
+ * Creates a sink which writes the items to the file at `path`.
+ *
+ * The file is created or truncated immediately.
+ * Items are formatted into a buffer of `buffer_size` bytes,
+ * a full buffer is written by a single `write()` call in the background,
+ * while the next items are formatted into a second buffer.
+ *
+ * If a write or sync fails, the sink stops, the upstream is cancelled
+ * and the error is rethrown as an `std::runtime_error` by `execution::wait()`:
+ *
+ * @code
+ * auto exec = (from(records) | to_csv | to_file("out.csv")).run(pool);
+ * exec.wait(); // throws if the file can't be written
+ * @endcode
+ *
+ * @param path Path of the file to write
+ * @param format `void format(const T& item, std::string& buffer)`, appends `item` to `buffer`
+ * @param buffer_size Size of a buffer in bytes, two buffers are used
+ * @param sync When the written data is synced to the storage device
+ * @returns A sink of `T` items
+ * @throws `std::runtime_error` If the file can't be opened
+ */
+template <typename Format = line_format>
+detail::file_sink_stage<Format>
+to_file(
+  const std::string& path,
+  Format format = Format(),
+  std::size_t buffer_size = 1 << 20,
+  sync_policy sync = sync_policy::none
+)
+{
+  const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+  {
+    throw std::runtime_error("Failed to open file: " + path);
+  }
+
+  return detail::file_sink_stage<Format>(
+    std::make_shared<detail::file_descriptor>(fd, true),
+    format, buffer_size, sync
+  );
+}
+
+/**
+ * Creates a sink which writes the items to the open file descriptor `fd`,
+ * e.g: `STDOUT_FILENO`, as described at `to_file()`.
+ *
+ * `fd` is not closed by the sink.
+ *
+ * @param fd File descriptor open for writing, must outlive the execution
+ * @param format `void format(const T& item, std::string& buffer)`, appends `item` to `buffer`
+ * @param buffer_size Size of a buffer in bytes, two buffers are used
+ * @param sync When the written data is synced to the storage device
+ * @returns A sink of `T` items
+ */
+template <typename Format = line_format>
+detail::file_sink_stage<Format>
+to_fd(
+  int fd,
+  Format format = Format(),
+  std::size_t buffer_size = 1 << 20,
+  sync_policy sync = sync_policy::none
+)
+{
+  return detail::file_sink_stage<Format>(
+    std::make_shared<detail::file_descriptor>(fd, false),
+    format, buffer_size, sync
+  );
+}
+
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_FILE_HPP
@@ -0,0 +1,374 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_JOIN_HPP
+#define BOOST_PIPELINE_JOIN_HPP
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include <exception>
+#include <type_traits>
+
+#include <boost/pipeline/queue.hpp>
+#include <boost/pipeline/threading.hpp>
+#include <boost/pipeline/detail/segment.hpp>
+#include <boost/pipeline/detail/whole_stream.hpp>
+#include <boost/pipeline/detail/flat_hash_table.hpp>
+#include <boost/pipeline/detail/batched_reader.hpp>
+
+namespace boost {
+namespace pipeline {
+
+namespace detail {
+
+template <typename Build, typename Probe, typename Output, typename Stage>
+class hash_join_task
+{
+  typedef typename std::decay<
+    decltype(std::declval<typename Stage::side_key_type>()(std::declval<const Build&>()))
+  >::type key_type;
+
+public:
+  hash_join_task(const Stage& stage, const queue_back<Output>& downstream)
+    :_build_input(std::make_shared<queue<Build>>()),
+     _probe_input(std::make_shared<queue<Probe>>()),
+     _downstream(downstream),
+     _stage(stage)
+  {}
+
+  void operator()()
+  {
+    flat_hash_table<key_type, Build> table;
+
+    queue_front<Build> build_side(*_build_input);
+    queue_front<Probe> probe_side(*_probe_input);
+
+    std::exception_ptr error;
+
+    try
+    {
+      Build build;
+      while (pull_or_cancel(build_side, _downstream, build))
+      {
+        key_type key = _stage.side_key(build);
+        table.insert_multi(key, std::move(build));
+      }
+
+      // an incomplete table would miss matches
+      error = build_side.error();
+
+      Probe probe;
+      while (! error && pull_or_cancel(probe_side, _downstream, probe))
+      {
+        table.for_each_match(_stage.key(probe), [&](const Build& match)
+        {
+          _downstream.push(_stage.combine(match, probe));
+        });
+      }
+
+      if (! error) { error = probe_side.error(); }
+    }
+    catch (...)
+    {
+      // reported by execution::wait()
+      error = std::current_exception();
+    }
+
+    _downstream.close(error);
+
+    if (error)
+    {
+      // the remaining items are not needed
+      build_side.cancel();
+      probe_side.cancel();
+    }
+  }
+
+  queue_back<Build> get_side_queue_back()
+  {
+    return queue_back<Build>(_build_input);
+  }
+
+  queue_back<Probe> get_queue_back()
+  {
+    return queue_back<Probe>(_probe_input);
+  }
+
+private:
+  std::shared_ptr<queue<Build>> _build_input;
+  std::shared_ptr<queue<Probe>> _probe_input;
+  queue_back<Output> _downstream;
+  Stage _stage;
+};
+
+template <typename Side, typename Input, typename Output, typename Stage>
+class merge_join_task
+{
+  static const std::size_t batch_size = 64;
+
+public:
+  merge_join_task(const Stage& stage, const queue_back<Output>& downstream)
+    :_side_input(std::make_shared<queue<Side>>()),
+     _input(std::make_shared<queue<Input>>()),
+     _downstream(downstream),
+     _stage(stage)
+  {}
+
+  void operator()()
+  {
+    batched_reader<Side> side(*_side_input, batch_size);
+    batched_reader<Input> input(*_input, batch_size);
+
+    // side items of the current key, only one if the side keys are unique
+    std::vector<Side> group;
+
+    std::exception_ptr error;
+
+    try
+    {
+      while (! _downstream.is_cancelled() && side.has_front() && input.has_front())
+      {
+        const auto side_key = _stage.side_key(side.front());
+        const auto key = _stage.key(input.front());
+
+        if (side_key < key)
+        {
+          side.pop();
+        }
+        else if (key < side_key)
+        {
+          input.pop();
+        }
+        else
+        {
+          group.clear();
+
+          while (side.has_front() && ! (side_key < _stage.side_key(side.front())))
+          {
+            group.push_back(std::move(side.front()));
+            side.pop();
+          }
+
+          while (input.has_front() && ! (key < _stage.key(input.front())))
+          {
+            for (const Side& match : group)
+            {
+              _downstream.push(_stage.combine(match, input.front()));
+            }
+
+            input.pop();
+          }
+        }
+      }
+    }
+    catch (...)
+    {
+      // reported by execution::wait()
+      error = std::current_exception();
+    }
+
+    // an exhausted input might have failed
+    if (! error) { error = _side_input->error() ? _side_input->error() : _input->error(); }
+
+    _downstream.close(error);
+
+    // the remaining items are not needed
+    side.cancel();
+    input.cancel();
+  }
+
+  queue_back<Side> get_side_queue_back()
+  {
+    return queue_back<Side>(_side_input);
+  }
+
+  queue_back<Input> get_queue_back()
+  {
+    return queue_back<Input>(_input);
+  }
+
+private:
+  std::shared_ptr<queue<Side>> _side_input;
+  std::shared_ptr<queue<Input>> _input;
+  queue_back<Output> _downstream;
+  Stage _stage;
+};
+
+/**
+ * Joins the items of the parent segment
+ * with the items of a side segment.
+ *
+ * The joining task is provided by `Stage`.
+ */
+template <typename Parent, typename Stage>
+class join_segment
+  : public basic_segment<
+      Parent,
+      typename Stage::template output_type<typename Parent::value_type>
+    >
+{
+  typedef basic_segment<
+    Parent,
+    typename Stage::template output_type<typename Parent::value_type>
+  > base_segment;
+
+public:
+  typedef typename base_segment::root_type  root_type;
+  typedef typename base_segment::input_type input_type;
+  typedef typename base_segment::value_type value_type;
+
+  typedef typename Stage::template task_type<input_type, value_type> task_type;
+
+  join_segment(const Parent& parent, const Stage& stage)
+    :base_segment(parent),
+     _stage(stage)
+  {}
+
+  /** @copydoc basic_segment::run */
+  void run(thread_pool& pool, const queue_back<value_type>& target)
+  {
+    task_type task(_stage, target);
+
+    _stage.side.run(pool, task.get_side_queue_back());
+    base_segment::_parent.run(pool, task.get_queue_back());
+
+    pool.submit(std::move(task));
+  }
+
+  std::unique_ptr<segment_concept<root_type, value_type>> clone() const
+  {
+    return std::unique_ptr<segment_concept<root_type, value_type>>(
+      new join_segment<Parent, Stage>(*this)
+    );
+  }
+
+private:
+  Stage _stage;
+};
+
+template <typename P, typename S>
+struct is_connectable_segment<join_segment<P, S>> : public std::true_type {};
+
+template <
+  template <typename, typename, typename, typename> class Task,
+  typename SideSegment, typename SideKey, typename Key, typename Combine
+>
+struct join_stage
+{
+  typedef typename SideSegment::value_type side_type;
+  typedef SideKey side_key_type;
+
+  template <typename Input>
+  using output_type = typename std::decay<decltype(
+    std::declval<Combine>()(std::declval<const side_type&>(), std::declval<const Input&>())
+  )>::type;
+
+  template <typename Input, typename Output>
+  using task_type = Task<side_type, Input, Output, join_stage>;
+
+  template <typename Plan>
+  using connect_type = join_segment<Plan, join_stage>;
+
+  SideSegment side;
+  SideKey side_key;
+  Key key;
+  Combine combine;
+};
+
+} // namespace detail
+
+/**
+ * Creates a stage which joins its input (the probe side)
+ * with the output of `build_side` on equal keys.
+ *
+ * First, the items of `build_side` are collected in an open addressing
+ * hash table. Then, for each item `p` arriving from the upstream,
+ * `combine(b, p)` is emitted for each collected `b` where
+ * `build_key(b) == probe_key(p)`. Neither of the inputs has to be
+ * sorted. The build side must be finite, the probe side might be
+ * unbounded and is processed as it arrives.
+ *
+ * @code
+ * auto relations = from(persons) | hash_join(
+ *   from(departments),
+ *   [](const department& d) { return d.id; },
+ *   [](const person& p) { return p.department_id; },
+ *   [](const department& d, const person& p) { return relation{d.name, p.name}; }
+ * );
+ * @endcode
+ *
+ * @param build_side Left-terminated segment producing `B` items
+ * @param build_key Key of a build item, `K build_key(const B&)`
+ * @param probe_key Key of a probe item, `K probe_key(const P&)`
+ * @param combine Produces the output of matching items, `R combine(const B&, const P&)`
+ * @returns A transformation of `P` items to `R` items
+ */
+template <typename BuildSegment, typename BuildKey, typename ProbeKey, typename Combine>
+detail::join_stage<detail::hash_join_task, BuildSegment, BuildKey, ProbeKey, Combine>
+hash_join(
+  const BuildSegment& build_side,
+  BuildKey build_key,
+  ProbeKey probe_key,
+  Combine combine
+)
+{
+  return detail::join_stage<detail::hash_join_task, BuildSegment, BuildKey, ProbeKey, Combine>{
+    build_side, build_key, probe_key, combine
+  };
+}
+
+/**
+ * Creates a stage which joins its input with the output
+ * of `side` on equal keys. Both inputs must be sorted by key
+ * in ascending order.
+ *
+ * The inputs are advanced in lock-step. For each key,
+ * the matching items of `side` are buffered and `combine(s, i)` is emitted
+ * for each of them and each matching item `i` of the upstream.
+ * Keys are compared using `operator<`. Many-to-many relations are supported,
+ * if the keys of `side` are unique, the stage takes constant memory.
+ *
+ * @code
+ * auto relations = from(persons) | merge_join(
+ *   from(departments),
+ *   [](const department& d) { return d.id; },
+ *   [](const person& p) { return p.department_id; },
+ *   [](const department& d, const person& p) { return relation{d.name, p.name}; }
+ * );
+ * @endcode
+ *
+ * @param side Left-terminated segment producing `S` items
+ * @param side_key Key of a side item, `K side_key(const S&)`
+ * @param key Key of an upstream item, `K key(const I&)`
+ * @param combine Produces the output of matching items, `R combine(const S&, const I&)`
+ * @returns A transformation of `I` items to `R` items
+ */
+template <typename SideSegment, typename SideKey, typename Key, typename Combine>
+detail::join_stage<detail::merge_join_task, SideSegment, SideKey, Key, Combine>
+merge_join(
+  const SideSegment& side,
+  SideKey side_key,
+  Key key,
+  Combine combine
+)
+{
+  return detail::join_stage<detail::merge_join_task, SideSegment, SideKey, Key, Combine>{
+    side, side_key, key, combine
+  };
+}
+
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_JOIN_HPP
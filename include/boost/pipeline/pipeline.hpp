@@ -69,6 +69,8 @@ from(const Iterator& begin, const Iterator& end)
  * The generator function receives a `queue_back<T>` argument
  * and feeds it with the generated items. The underlying queue
  * will be automatically closed upon return of the generator.
+ * The generator should return if `queue_back<T>::is_cancelled()`
+ * returns true, e.g: because of a downstream `take()`.
  *
  * @param generator An `std::function` receiving a single `queue_back<T>` argument.
  * @returns `segment<terminated, T>`
@@ -0,0 +1,187 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_PRIORITY_HPP
+#define BOOST_PIPELINE_PRIORITY_HPP
+
+#include <deque>
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+
+#include <boost/pipeline/queue.hpp>
+#include <boost/pipeline/detail/segment.hpp>
+#include <boost/pipeline/detail/hold_back.hpp>
+
+namespace boost {
+namespace pipeline {
+
+namespace detail {
+
+/**
+ * FIFO lanes of pending items, lane 0 has the highest priority.
+ *
+ * The front of the highest priority non-empty lane is popped,
+ * unless a lower priority lane was passed over `max_bypass` times
+ * while it had items: then, it's served first. If `max_bypass` is 0,
+ * lower priority lanes are served only if the higher ones are empty.
+ */
+template <typename T>
+class priority_lanes
+{
+public:
+  priority_lanes(std::size_t lanes, std::size_t max_bypass)
+    :_lanes(std::max<std::size_t>(1, lanes)),
+     _bypassed(_lanes.size(), 0),
+     _max_bypass(max_bypass),
+     _size(0)
+  {}
+
+  /** `lane` is clamped to the lowest priority lane */
+  void put(std::size_t lane, T&& item)
+  {
+    _lanes[std::min(lane, _lanes.size() - 1)].push_back(std::move(item));
+    ++_size;
+  }
+
+  /** @pre `! empty()` */
+  T pop()
+  {
+    const std::size_t served = next_lane();
+
+    for (std::size_t lane = served + 1; lane < _lanes.size(); ++lane)
+    {
+      if (! _lanes[lane].empty()) { ++_bypassed[lane]; }
+    }
+
+    _bypassed[served] = 0;
+
+    T item = std::move(_lanes[served].front());
+    _lanes[served].pop_front();
+    --_size;
+    return item;
+  }
+
+  bool empty() const { return _size == 0; }
+  std::size_t size() const { return _size; }
+
+private:
+  std::size_t next_lane() const
+  {
+    std::size_t first = 0;
+    while (_lanes[first].empty()) { ++first; }
+
+    for (std::size_t lane = first + 1; lane < _lanes.size(); ++lane)
+    {
+      if (_max_bypass && ! _lanes[lane].empty() && _bypassed[lane] >= _max_bypass)
+      {
+        return lane;
+      }
+    }
+
+    return first;
+  }
+
+  std::vector<std::deque<T>> _lanes;
+  std::vector<std::size_t> _bypassed;
+  std::size_t _max_bypass;
+  std::size_t _size;
+};
+
+template <typename PriorityFn>
+class prioritize_stage
+{
+public:
+  template <typename Plan>
+  using connect_type = n_m_segment<Plan, typename Plan::value_type, void>;
+
+  prioritize_stage(
+    const PriorityFn& priority_fn,
+    std::size_t lanes,
+    std::size_t max_bypass,
+    std::size_t max_depth
+  )
+    :_priority_fn(priority_fn),
+     _lanes(lanes),
+     _max_bypass(max_bypass),
+     _max_depth(std::max<std::size_t>(1, max_depth))
+  {}
+
+  template <typename T>
+  void operator()(queue_front<T>& upstream, queue_back<T>& downstream) const
+  {
+    // whole-stream stage, hold_back handles the cancellation
+    priority_lanes<T> pending(_lanes, _max_bypass);
+
+    const PriorityFn& priority_fn = _priority_fn;
+    hold_back(upstream, downstream, _max_depth, pending,
+      [&priority_fn](priority_lanes<T>& buffer, T&& item)
+      {
+        const std::size_t lane = priority_fn(item);
+        buffer.put(lane, std::move(item));
+      }
+    );
+  }
+
+private:
+  PriorityFn _priority_fn;
+  std::size_t _lanes;
+  std::size_t _max_bypass;
+  std::size_t _max_depth;
+};
+
+} // namespace detail
+
+/**
+ * Creates a stage which passes urgent items ahead of the others
+ * while the downstream is busy.
+ *
+ * Items are passed on while the downstream queue holds less than
+ * `max_depth` items. Otherwise, they are held back in `lanes` FIFO lanes
+ * selected by `priority_fn`, lane 0 being the most urgent. The next item
+ * is taken from the most urgent non-empty lane, but a lane passed over
+ * `max_bypass` times is served first, therefore low priority items
+ * are not starved. If `max_bypass` is 0, there is no such bound:
+ * a lane is served only if the more urgent lanes are empty.
+ *
+ * Unlike `route()`, urgent and bulk items are processed by the same segments:
+ *
+ * @code
+ * auto urgency = [](const request& r) { return (r.is_priority) ? 0 : 1; };
+ * from(requests) | prioritize(urgency, 2) | parse_request | request_id | respond
+ * @endcode
+ *
+ * @param priority_fn Lane of an item, `std::size_t priority_fn(const T&)`,
+ *                    values above `lanes - 1` select the last lane
+ * @param lanes Number of priority lanes
+ * @param max_bypass Number of times a non-empty lane might be passed over,
+ *                   0 for strict priority
+ * @param max_depth Number of items the downstream queue may hold
+ * @returns A transformation of `T` items to the same items, reordered by priority
+ */
+template <typename PriorityFn>
+detail::prioritize_stage<PriorityFn>
+prioritize(
+  PriorityFn priority_fn,
+  std::size_t lanes,
+  std::size_t max_bypass = 16,
+  std::size_t max_depth = 1
+)
+{
+  return detail::prioritize_stage<PriorityFn>(priority_fn, lanes, max_bypass, max_depth);
+}
+
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_PRIORITY_HPP
@@ -13,15 +13,84 @@
 #ifndef BOOST_PIPELINE_QUEUE_HPP
 #define BOOST_PIPELINE_QUEUE_HPP
 
+#include <cstddef>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <exception>
+
 #include <boost/thread/sync_queue.hpp>
+#include <boost/thread/thread_only.hpp>
 
 #define BOOST_THREAD_QUEUE_DEPRECATE_OLD
 
 namespace boost {
 namespace pipeline {
 
+/**
+ * Buffer queue between segments.
+ *
+ * A `sync_queue` which can be cancelled by its consumer,
+ * to signal the producers that further items are not needed.
+ * A failed producer leaves its error in the queue,
+ * to be reported by the consumer.
+ */
 template <typename T>
-using queue = sync_queue<T>;
+class queue : public sync_queue<T>
+{
+public:
+  queue()
+    :_cancelled(false)
+  {}
+
+  /** Requests the producers to stop pushing, the further items are discarded */
+  void cancel()
+  {
+    _cancelled.store(true, std::memory_order_relaxed);
+  }
+
+  /** Adds an item to the queue, unless the queue is cancelled */
+  void push(const T& item)
+  {
+    if (! is_cancelled()) { sync_queue<T>::push(item); }
+  }
+
+  /** @copydoc push */
+  void push(T&& item)
+  {
+    if (! is_cancelled()) { sync_queue<T>::push(std::move(item)); }
+  }
+
+  /** @returns true, if the consumer requested the producers to stop */
+  bool is_cancelled() const
+  {
+    return _cancelled.load(std::memory_order_relaxed);
+  }
+
+  /** Records the failure of a producer, the first error is kept */
+  void set_error(const std::exception_ptr& error)
+  {
+    std::lock_guard<std::mutex> lock(_error_mutex);
+    if (! _error) { _error = error; }
+  }
+
+  /** @returns The error a producer failed with, if any */
+  std::exception_ptr error() const
+  {
+    std::lock_guard<std::mutex> lock(_error_mutex);
+    return _error;
+  }
+
+private:
+  std::atomic<bool> _cancelled;
+
+  mutable std::mutex _error_mutex;
+  std::exception_ptr _error;
+};
 
 /**
  * Producer handle to buffer queue between segments.
@@ -30,7 +99,9 @@ using queue = sync_queue<T>;
  * receive a `queue_back` instance which is used to access to
  * the downstream queue.
  *
- * A handle is valid until the downstream segment terminates.
+ * A handle to a queue between two segments shares the ownership
+ * of the queue: it remains valid after the downstream segment terminates.
+ * A handle to a user provided queue is valid until the queue is destroyed.
  *
  * **Template arguments**:
  *
@@ -39,6 +110,8 @@ using queue = sync_queue<T>;
 template <typename T>
 class queue_back
 {
+  struct producer_group;
+
 public:
   /** Value type of the underlying queue */
   typedef typename queue<T>::value_type value_type;
@@ -55,6 +128,16 @@ public:
     :_queue(queue)
   {}
 
+  /**
+   * Creates a handle sharing the ownership of the given queue.
+   *
+   * @param queue_ptr Queue to be accessed
+   */
+  queue_back(const std::shared_ptr<queue<T>>& queue_ptr)
+    :_queue(*queue_ptr),
+     _owner(queue_ptr)
+  {}
+
   /**
    * Pushes an item to the underlying queue.
    *
@@ -73,18 +156,100 @@ public:
     _queue.push(std::forward<T>(item));
   }
 
+  /**
+   * Gets the number of items pending in the underlying queue.
+   *
+   * This call is subject to race.
+   *
+   * @returns Number of items not yet pulled by the consumer
+   */
+  std::size_t size() const
+  {
+    return _queue.size();
+  }
+
+  /**
+   * Checks whether the consumer cancelled the underlying queue.
+   *
+   * Producers should stop pushing and close
+   * their handle as soon as possible if it returns true,
+   * the pushed items are discarded anyway.
+   *
+   * @returns true, if the queue is cancelled, false otherwise
+   */
+  bool is_cancelled() const
+  {
+    return _queue.is_cancelled();
+  }
+
   /**
    * Closes the underlying queue.
    *
    * Queue will not receive additional items.
+   * If this handle is created by `split()`, the queue is closed
+   * only if each handle of the group is closed.
    */
   void close()
   {
-    _queue.close();
+    if (_group)
+    {
+      if (--_group->open == 0) { _group->downstream.close(); }
+    }
+    else
+    {
+      _queue.close();
+    }
+  }
+
+  /**
+   * Closes the underlying queue, reporting a failure.
+   *
+   * The consumer receives `error` via `queue_front::error()`.
+   * A null `error` is not a failure, the call is the same as `close()`.
+   *
+   * @param error The error the producer failed with
+   */
+  void close(const std::exception_ptr& error)
+  {
+    if (error) { _queue.set_error(error); }
+    close();
+  }
+
+  /**
+   * Creates handles for several producers, sharing the underlying queue.
+   *
+   * Each producer must close its own handle, the underlying queue
+   * is closed by the last one.
+   *
+   * @param producers Number of handles to create
+   * @returns `producers` handles to the underlying queue
+   */
+  std::vector<queue_back<T>> split(std::size_t producers) const
+  {
+    auto group = std::make_shared<producer_group>(*this, producers);
+    return std::vector<queue_back<T>>(producers, queue_back<T>(_queue, group));
   }
 
 private:
+  struct producer_group
+  {
+    producer_group(const queue_back<T>& downstream, std::size_t open)
+      :downstream(downstream),
+       open(open)
+    {}
+
+    queue_back<T> downstream;
+    std::atomic<std::size_t> open;
+  };
+
+  queue_back(queue<T>& queue, const std::shared_ptr<producer_group>& group)
+    :_queue(queue),
+     _group(group)
+  {}
+
   queue<T>& _queue;
+  std::shared_ptr<queue<T>> _owner; /**< set if the queue is shared */
+  std::shared_ptr<producer_group> _group; /**< set if created by split() */
 };
 
 /**
@@ -131,10 +296,66 @@ public:
    */
   bool wait_pull(T& ret)
   {
+    // an interrupted consumer would never cancel its producers
+    this_thread::disable_interruption no_interruption;
+
     auto status = _queue.wait_pull(ret);
     return (status == queue_op_status::success);
   }
 
+  /**
+   * Pulls the front item of the queue, if any.
+   *
+   * Does not block if the queue is empty.
+   *
+   * @param ret Pulled item, if any
+   * @returns true, if pulled successfully, false otherwise (queue is empty or closed)
+   */
+  bool try_pull(T& ret)
+  {
+    auto status = _queue.try_pull(ret);
+    return (status == queue_op_status::success);
+  }
+
+  /**
+   * Pulls the front item of the queue.
+   *
+   * Blocks until an item becomes available,
+   * the underlying queue gets closed or `deadline` is reached.
+   *
+   * The underlying queue provides no timed wait,
+   * therefore the caller is put to sleep for short,
+   * increasing intervals while the queue is empty.
+   *
+   * @param ret Pulled item, if any
+   * @param deadline Point in time after the call gives up
+   * @returns true, if pulled successfully, false otherwise (queue is closed or timed out)
+   */
+  template <typename Clock, typename Duration>
+  bool wait_pull_until(T& ret, const std::chrono::time_point<Clock, Duration>& deadline)
+  {
+    typedef typename Clock::duration clock_duration;
+
+    const clock_duration max_backoff = std::chrono::milliseconds(1);
+    clock_duration backoff = std::chrono::microseconds(20);
+
+    while (true)
+    {
+      auto status = _queue.try_pull(ret);
+      if (status == queue_op_status::success) { return true; }
+      if (status == queue_op_status::closed)  { return false; }
+
+      const auto now = Clock::now();
+      if (now >= deadline) { return false; }
+
+      std::this_thread::sleep_for(std::min(
+        backoff,
+        std::chrono::duration_cast<clock_duration>(deadline - now)
+      ));
+      backoff = std::min(backoff * 2, max_backoff);
+    }
+  }
+
   /**
    * Checks the underlying queue for emptiness.
    *
@@ -157,6 +378,42 @@ public:
     return _queue.closed();
   }
 
+  /**
+   * Cancels the underlying queue: signals the producers that
+   * no more items are needed and discards the pending items.
+   * Does not wait for the producers, the further items
+   * are discarded by the queue.
+   *
+   * Producers of the library stop at the next item
+   * and cancel their own upstream in turn.
+   */
+  void cancel()
+  {
+    _queue.cancel();
+
+    T discarded;
+    while (try_pull(discarded)) {}
+  }
+
+  /** @returns true, if the underlying queue is cancelled */
+  bool is_cancelled() const
+  {
+    return _queue.is_cancelled();
+  }
+
+  /**
+   * Gets the failure of the producers.
+   *
+   * Each segment closes its downstream with the error of its upstream,
+   * the sinks report it through `execution::wait()`.
+   *
+   * @returns The error a producer failed with, if any, null otherwise
+   */
+  std::exception_ptr error() const
+  {
+    return _queue.error();
+  }
+
 private:
   queue<T>& _queue;
 };
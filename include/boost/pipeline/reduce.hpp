@@ -0,0 +1,318 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_REDUCE_HPP
+#define BOOST_PIPELINE_REDUCE_HPP
+
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+
+#include <boost/pipeline/queue.hpp>
+#include <boost/pipeline/threading.hpp>
+#include <boost/pipeline/detail/task.hpp>
+#include <boost/pipeline/detail/segment.hpp>
+#include <boost/pipeline/detail/whole_stream.hpp>
+#include <boost/pipeline/detail/flat_hash_table.hpp>
+
+namespace boost {
+namespace pipeline {
+
+namespace detail {
+
+/**
+ * Reduces the items of the parent segment by key.
+ *
+ * If `Stage::workers` is 1, a single task combines the items.
+ * Otherwise, the workers pull the items from a shared queue
+ * and combine the items of the same key into partial results,
+ * which are flushed to the final task each time `Stage::flush_size`
+ * different keys are collected. The final task combines the partials
+ * and emits the final results when the upstream is closed.
+ */
+template <typename Parent, typename Stage>
+class reduce_by_key_segment
+  : public basic_segment<Parent, typename Parent::value_type>
+{
+  typedef basic_segment<Parent, typename Parent::value_type> base_segment;
+
+public:
+  typedef typename base_segment::root_type  root_type;
+  typedef typename base_segment::input_type input_type;
+  typedef typename base_segment::value_type value_type;
+
+  typedef std::function<void(
+    queue_front<value_type>&,
+    queue_back<value_type>&
+  )> function_type;
+
+  typedef n_m_task<value_type, value_type, function_type> task_type;
+
+  reduce_by_key_segment(const Parent& parent, const Stage& stage)
+    :base_segment(parent),
+     _stage(stage)
+  {}
+
+  /** @copydoc basic_segment::run */
+  void run(thread_pool& pool, const queue_back<value_type>& target)
+  {
+    const Stage stage = _stage;
+
+    function_type combine_partials = [stage](
+      queue_front<value_type>& upstream, queue_back<value_type>& downstream
+    )
+    {
+      stage.template reduce<value_type>(upstream, downstream, 0);
+    };
+
+    task_type final_task(combine_partials, target);
+
+    if (stage.workers <= 1)
+    {
+      base_segment::_parent.run(pool, final_task.get_queue_back());
+      pool.submit(std::move(final_task));
+      return;
+    }
+
+    function_type pre_aggregate = [stage](
+      queue_front<value_type>& upstream, queue_back<value_type>& downstream
+    )
+    {
+      stage.template reduce<value_type>(upstream, downstream, stage.flush_size);
+    };
+
+    auto input = std::make_shared<queue<value_type>>();
+    auto partials = final_task.get_queue_back().split(stage.workers);
+
+    base_segment::_parent.run(pool, queue_back<value_type>(input));
+
+    pool.submit(std::move(final_task));
+
+    for (const queue_back<value_type>& partial : partials)
+    {
+      pool.submit(task_type(pre_aggregate, partial, input));
+    }
+  }
+
+  std::unique_ptr<segment_concept<root_type, value_type>> clone() const
+  {
+    return std::unique_ptr<segment_concept<root_type, value_type>>(
+      new reduce_by_key_segment<Parent, Stage>(*this)
+    );
+  }
+
+private:
+  Stage _stage;
+};
+
+template <typename P, typename S>
+struct is_connectable_segment<reduce_by_key_segment<P, S>> : public std::true_type {};
+
+template <typename KeyFn, typename Combine>
+struct reduce_by_key_stage
+{
+  template <typename Plan>
+  using connect_type = reduce_by_key_segment<Plan, reduce_by_key_stage>;
+
+  /**
+   * Combines the items of `upstream` by key, until it gets closed.
+   *
+   * If `max_keys` is positive, the collected results are pushed
+   * to `downstream` each time `max_keys` different keys are collected.
+   */
+  template <typename T>
+  void reduce(
+    queue_front<T>& upstream,
+    queue_back<T>& downstream,
+    std::size_t max_keys
+  ) const
+  {
+    typedef typename std::decay<
+      decltype(std::declval<const KeyFn&>()(std::declval<const T&>()))
+    >::type key_type;
+
+    // whole-stream stage, see pull_or_cancel
+    flat_hash_table<key_type, T> table(max_keys);
+
+    auto flush = [&]()
+    {
+      table.for_each([&](const key_type&, const T& result)
+      {
+        downstream.push(result);
+      });
+
+      table.clear();
+    };
+
+    T item;
+    while (pull_or_cancel(upstream, downstream, item))
+    {
+      auto found = table.insert(key_fn(item), item);
+      if (! found.second)
+      {
+        *found.first = combine(*found.first, item);
+      }
+      else if (max_keys && table.size() >= max_keys)
+      {
+        flush();
+      }
+    }
+
+    if (downstream.is_cancelled()) { return; }
+
+    flush();
+  }
+
+  KeyFn key_fn;
+  Combine combine;
+  std::size_t flush_size;
+  std::size_t workers;
+};
+
+template <typename Compare>
+class top_k_stage
+{
+public:
+  template <typename Plan>
+  using connect_type = n_m_segment<Plan, typename Plan::value_type, void>;
+
+  top_k_stage(std::size_t k, const Compare& compare)
+    :_k(k),
+     _compare(compare)
+  {}
+
+  template <typename T>
+  void operator()(queue_front<T>& upstream, queue_back<T>& downstream) const
+  {
+    // min-heap: the least of the best k items is on top
+    auto greater = [this](const T& a, const T& b) { return _compare(b, a); };
+
+    // whole-stream stage, see pull_or_cancel
+    std::vector<T> heap;
+    heap.reserve(_k);
+
+    T item;
+    while (pull_or_cancel(upstream, downstream, item))
+    {
+      if (heap.size() < _k)
+      {
+        heap.push_back(std::move(item));
+        std::push_heap(heap.begin(), heap.end(), greater);
+      }
+      else if (_k && _compare(heap.front(), item))
+      {
+        std::pop_heap(heap.begin(), heap.end(), greater);
+        heap.back() = std::move(item);
+        std::push_heap(heap.begin(), heap.end(), greater);
+      }
+    }
+
+    if (downstream.is_cancelled()) { return; }
+
+    std::sort_heap(heap.begin(), heap.end(), greater);
+
+    for (auto& best : heap)
+    {
+      downstream.push(std::move(best));
+    }
+  }
+
+private:
+  std::size_t _k;
+  Compare _compare;
+};
+
+} // namespace detail
+
+/**
+ * Creates a stage which combines the items of equal keys.
+ *
+ * For each distinct `key_fn(item)`, a single result is emitted
+ * when the upstream gets closed: the items of the key folded using `combine`.
+ * The items are combined in an open addressing hash table.
+ *
+ * If `workers` is greater than 1, the items are pre-aggregated
+ * concurrently by `workers` tasks, each in a table of at most `flush_size`
+ * keys, which is flushed to a final combiner task if full. Only the partial
+ * results are passed to the final combiner, i.e: for a low number of keys,
+ * it receives only a few items. The pipeline takes `workers` additional threads.
+ *
+ * The order of the results is unspecified. The keys and the items
+ * must be default constructible and hashable by `std::hash`.
+ *
+ * @code
+ * auto count = [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b)
+ * {
+ *   return std::make_pair(a.first, a.second + b.second);
+ * };
+ *
+ * from(words) | to_pair_of_one | reduce_by_key(get_first, count) | word_counts
+ * @endcode
+ *
+ * @param key_fn Key of an item, `K key_fn(const T&)`
+ * @param combine Associative and commutative operation, `T combine(const T&, const T&)`
+ * @param flush_size Maximum number of keys pre-aggregated before flushing partials
+ * @param workers Number of tasks pre-aggregating the items, 1 if no pre-aggregation is needed
+ * @returns A transformation of `T` items to `T` results
+ */
+template <typename KeyFn, typename Combine>
+detail::reduce_by_key_stage<KeyFn, Combine>
+reduce_by_key(
+  KeyFn key_fn,
+  Combine combine,
+  std::size_t flush_size = 4096,
+  std::size_t workers = 1
+)
+{
+  return detail::reduce_by_key_stage<KeyFn, Combine>{key_fn, combine, flush_size, workers};
+}
+
+/**
+ * Creates a stage which emits the `k` greatest items of its input
+ * in descending order, when the upstream gets closed.
+ *
+ * Only the best `k` items are kept in a binary heap,
+ * each item takes O(log k) comparisons. If the input has less
+ * than `k` items, every item is emitted.
+ *
+ * The stage is mergeable: applied on several inputs then on the
+ * merged results, it gives the top items of every input. This way,
+ * the heaps are maintained concurrently:
+ *
+ * @code
+ * auto by_score = [](const hit& a, const hit& b) { return a.score < b.score; };
+ *
+ * auto exec = (
+ *     merge(from(shard_a) | top_k(10, by_score), from(shard_b) | top_k(10, by_score))
+ *   | top_k(10, by_score)
+ *   | best_hits
+ * ).run(pool);
+ * @endcode
+ *
+ * @param k Number of items to emit
+ * @param compare Strict weak ordering, `bool compare(const T&, const T&)`
+ * @returns A transformation of `T` items to the `k` greatest `T` items
+ */
+template <typename Compare>
+detail::top_k_stage<Compare>
+top_k(std::size_t k, Compare compare)
+{
+  return detail::top_k_stage<Compare>(k, compare);
+}
+
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_REDUCE_HPP
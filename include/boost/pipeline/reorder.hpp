@@ -0,0 +1,255 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_REORDER_HPP
+#define BOOST_PIPELINE_REORDER_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+#include <boost/assert.hpp>
+
+#include <boost/pipeline/queue.hpp>
+#include <boost/pipeline/detail/segment.hpp>
+#include <boost/pipeline/detail/whole_stream.hpp>
+
+namespace boost {
+namespace pipeline {
+
+namespace detail {
+
+/** Gap policy: missing items in [first, last) are skipped */
+struct skip_gaps
+{
+  template <typename T>
+  void operator()(std::uint64_t, std::uint64_t, queue_back<T>&) const {}
+};
+
+/** Gap policy: missing items in [first, last) are replaced by `fill(seq)` */
+template <typename Fill>
+struct fill_gaps
+{
+  template <typename T>
+  void operator()(std::uint64_t first, std::uint64_t last, queue_back<T>& downstream) const
+  {
+    for (std::uint64_t seq = first; seq < last; ++seq)
+    {
+      downstream.push(fill(seq));
+    }
+  }
+
+  Fill fill;
+};
+
+/**
+ * Ring of `size` slots, the slot of sequence number `n`
+ * is `n % size`. Holds items of at most `size` consecutive
+ * sequence numbers, starting from the next one to be emitted.
+ */
+template <typename T>
+class reorder_buffer
+{
+public:
+  explicit reorder_buffer(std::size_t size)
+    :_items(size),
+     _present(size, false)
+  {}
+
+  bool has(std::uint64_t seq) const { return _present[slot_of(seq)]; }
+
+  void put(std::uint64_t seq, T&& item)
+  {
+    const std::size_t slot = slot_of(seq);
+    _items[slot] = std::move(item);
+    _present[slot] = true;
+  }
+
+  T take(std::uint64_t seq)
+  {
+    const std::size_t slot = slot_of(seq);
+    _present[slot] = false;
+    return std::move(_items[slot]);
+  }
+
+  std::size_t size() const { return _items.size(); }
+
+private:
+  std::size_t slot_of(std::uint64_t seq) const
+  {
+    return static_cast<std::size_t>(seq % _items.size());
+  }
+
+  std::vector<T> _items;
+  std::vector<bool> _present;
+};
+
+template <typename SeqFn, typename GapPolicy>
+class reorder_stage
+{
+public:
+  template <typename Plan>
+  using connect_type = n_m_segment<Plan, typename Plan::value_type, void>;
+
+  /** A `max_window` of 0 is taken as 1 */
+  reorder_stage(
+    const SeqFn& seq_fn,
+    std::size_t max_window,
+    std::uint64_t start,
+    const GapPolicy& on_gap
+  )
+    :_seq_fn(seq_fn),
+     _max_window(std::max<std::size_t>(max_window, 1)),
+     _start(start),
+     _on_gap(on_gap)
+  {}
+
+  template <typename T>
+  void operator()(queue_front<T>& upstream, queue_back<T>& downstream) const
+  {
+    // whole-stream stage, see pull_or_cancel
+    reorder_buffer<T> buffer(_max_window);
+
+    std::uint64_t next = _start; // next sequence number to be emitted
+    std::uint64_t end = _start;  // past the greatest buffered sequence number
+
+    T item;
+    while (pull_or_cancel(upstream, downstream, item))
+    {
+      const std::uint64_t seq = _seq_fn(item);
+
+      // late or duplicate
+      if (seq < next || (seq < end && buffer.has(seq))) { continue; }
+
+      // window is full: give up the oldest missing items
+      if (seq >= next + buffer.size())
+      {
+        const std::uint64_t new_next = seq - buffer.size() + 1;
+
+        while (next < new_next && next < end)
+        {
+          emit(buffer, next++, downstream);
+        }
+
+        if (next < new_next)
+        {
+          _on_gap(next, new_next, downstream);
+          next = new_next;
+        }
+      }
+
+      buffer.put(seq, std::move(item));
+      if (seq >= end) { end = seq + 1; }
+
+      while (next < end && buffer.has(next))
+      {
+        downstream.push(buffer.take(next++));
+      }
+    }
+
+    if (downstream.is_cancelled()) { return; }
+
+    while (next < end)
+    {
+      emit(buffer, next++, downstream);
+    }
+  }
+
+private:
+  template <typename T>
+  void emit(reorder_buffer<T>& buffer, std::uint64_t seq, queue_back<T>& downstream) const
+  {
+    if (buffer.has(seq))
+    {
+      downstream.push(buffer.take(seq));
+    }
+    else
+    {
+      _on_gap(seq, seq + 1, downstream);
+    }
+  }
+
+  SeqFn _seq_fn;
+  std::size_t _max_window;
+  std::uint64_t _start;
+  GapPolicy _on_gap;
+};
+
+} // namespace detail
+
+/**
+ * Creates a stage which emits the items of its input
+ * in the order of their sequence numbers.
+ *
+ * The sequence starts at `start`, 0 by default. Items arriving
+ * ahead of the next number are buffered in a ring of `max_window` slots.
+ * If an item doesn't fit in the window, the missing numbers at the front
+ * are given up and skipped. Missing numbers are skipped as well when
+ * the upstream gets closed. Late items, i.e: arriving after their number
+ * is emitted or skipped, and duplicates are dropped.
+ *
+ * @code
+ * from(packets) | reorder([](const packet& p) { return p.seq; }, 1024) | decode
+ * @endcode
+ *
+ * @param seq_fn Sequence number of an item, `std::uint64_t seq_fn(const T&)`
+ * @param max_window Maximum number of buffered items, must be positive,
+ *                   if asserts are disabled, 0 is taken as 1
+ * @param start Sequence number of the first item
+ * @returns A transformation of `T` items to `T` items, ordered
+ */
+template <typename SeqFn>
+detail::reorder_stage<SeqFn, detail::skip_gaps>
+reorder(SeqFn seq_fn, std::size_t max_window, std::uint64_t start = 0)
+{
+  BOOST_ASSERT(max_window > 0);
+
+  return detail::reorder_stage<SeqFn, detail::skip_gaps>(
+    seq_fn, max_window, start, detail::skip_gaps()
+  );
+}
+
+/**
+ * Creates a stage which emits the items of its input
+ * in the order of their sequence numbers, filling the gaps.
+ *
+ * Works as `reorder(seq_fn, max_window, start)`, but `fill(seq)`
+ * is emitted in place of each skipped sequence number, therefore
+ * the output has no gaps.
+ *
+ * @param seq_fn Sequence number of an item, `std::uint64_t seq_fn(const T&)`
+ * @param max_window Maximum number of buffered items, must be positive
+ * @param fill Creates an item in place of a missing one, `T fill(std::uint64_t seq)`
+ * @param start Sequence number of the first item
+ * @returns A transformation of `T` items to `T` items, ordered
+ */
+template <
+  typename SeqFn, typename Fill,
+  typename = typename std::enable_if<! std::is_integral<Fill>::value>::type
+>
+detail::reorder_stage<SeqFn, detail::fill_gaps<Fill>>
+reorder(SeqFn seq_fn, std::size_t max_window, Fill fill, std::uint64_t start = 0)
+{
+  BOOST_ASSERT(max_window > 0);
+
+  return detail::reorder_stage<SeqFn, detail::fill_gaps<Fill>>(
+    seq_fn, max_window, start, detail::fill_gaps<Fill>{fill}
+  );
+}
+
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_REORDER_HPP
@@ -0,0 +1,224 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_SCAN_HPP
+#define BOOST_PIPELINE_SCAN_HPP
+
+#include <vector>
+#include <future>
+#include <thread>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+
+#include <boost/pipeline/queue.hpp>
+#include <boost/pipeline/detail/segment.hpp>
+#include <boost/pipeline/detail/whole_stream.hpp>
+
+namespace boost {
+namespace pipeline {
+
+namespace detail {
+
+template <typename Acc, typename Op>
+class scan_stage
+{
+public:
+  template <typename Plan>
+  using connect_type = n_m_segment<Plan, Acc, void>;
+
+  scan_stage(const Acc& init, const Op& op)
+    :_init(init),
+     _op(op)
+  {}
+
+  template <typename T>
+  void operator()(queue_front<T>& upstream, queue_back<Acc>& downstream) const
+  {
+    // whole-stream stage, see pull_or_cancel
+    Acc acc = _init;
+
+    T item;
+    while (pull_or_cancel(upstream, downstream, item))
+    {
+      acc = _op(acc, item);
+      downstream.push(acc);
+    }
+  }
+
+private:
+  Acc _init;
+  Op _op;
+};
+
+template <typename Init, typename Op>
+class parallel_scan_stage
+{
+  static const std::size_t min_chunk_size = 4096;
+
+public:
+  template <typename Plan>
+  using connect_type = n_m_segment<Plan, typename Plan::value_type, void>;
+
+  parallel_scan_stage(const Init& init, const Op& op, std::size_t max_threads)
+    :_init(init),
+     _op(op),
+     _max_threads(std::max<std::size_t>(1, max_threads))
+  {}
+
+  template <typename T>
+  void operator()(
+    queue_front<std::vector<T>>& upstream,
+    queue_back<std::vector<T>>& downstream
+  ) const
+  {
+    T carry(_init);
+
+    std::vector<T> items;
+    while (pull_or_cancel(upstream, downstream, items))
+    {
+      if (items.empty()) { continue; }
+
+      const std::size_t chunks = std::min(_max_threads, items.size() / min_chunk_size);
+
+      if (chunks < 2)
+      {
+        for (T& item : items)
+        {
+          item = _op(carry, item);
+          carry = item;
+        }
+      }
+      else
+      {
+        scan_chunks(items, chunks, carry);
+        carry = items.back();
+      }
+
+      downstream.push(std::move(items));
+    }
+  }
+
+private:
+  /**
+   * Scans `chunks` parts of `items` concurrently, in two passes:
+   * first, each part is scanned on its own, then the total of
+   * the preceding parts is applied on each item.
+   */
+  template <typename T>
+  void scan_chunks(std::vector<T>& items, std::size_t chunks, const T& carry) const
+  {
+    const std::size_t chunk_size = (items.size() + chunks - 1) / chunks;
+
+    auto chunk_begin = [&](std::size_t i) { return std::min(i * chunk_size, items.size()); };
+
+    std::vector<std::future<void>> parts;
+    parts.reserve(chunks);
+
+    for (std::size_t i = 0; i < chunks; ++i)
+    {
+      parts.push_back(std::async(std::launch::async, [&, i]()
+      {
+        const std::size_t end = chunk_begin(i + 1);
+        for (std::size_t j = chunk_begin(i) + 1; j < end; ++j)
+        {
+          items[j] = _op(items[j - 1], items[j]);
+        }
+      }));
+    }
+
+    for (auto& part : parts) { part.get(); }
+
+    // offset of each chunk: carry and the total of the preceding chunks
+    std::vector<T> offsets(1, carry);
+    for (std::size_t i = 1; i < chunks; ++i)
+    {
+      offsets.push_back(_op(offsets.back(), items[chunk_begin(i) - 1]));
+    }
+
+    parts.clear();
+
+    for (std::size_t i = 0; i < chunks; ++i)
+    {
+      parts.push_back(std::async(std::launch::async, [&, i]()
+      {
+        const std::size_t end = chunk_begin(i + 1);
+        for (std::size_t j = chunk_begin(i); j < end; ++j)
+        {
+          items[j] = _op(offsets[i], items[j]);
+        }
+      }));
+    }
+
+    for (auto& part : parts) { part.get(); }
+  }
+
+  Init _init;
+  Op _op;
+  std::size_t _max_threads;
+};
+
+} // namespace detail
+
+/**
+ * Creates a stage which emits the running accumulation of its input.
+ *
+ * For each item, `acc = op(acc, item)` is computed and emitted,
+ * where `acc` is initially `init`. The accumulator is kept
+ * by the stage, `op` doesn't have to be stateful.
+ *
+ * @code
+ * auto ema = [](double avg, double x) { return 0.9 * avg + 0.1 * x; };
+ * from(latencies) | scan(0.0, ema) | plot
+ * @endcode
+ *
+ * @param init Initial value of the accumulator, of type `A`
+ * @param op Accumulation, `A op(const A&, const T&)`
+ * @returns A transformation of `T` items to `A` accumulations
+ */
+template <typename Acc, typename Op>
+detail::scan_stage<Acc, Op>
+scan(Acc init, Op op)
+{
+  return detail::scan_stage<Acc, Op>(init, op);
+}
+
+/**
+ * Creates a stage which emits the running accumulation
+ * of batched items, using several threads for large batches.
+ *
+ * Each `std::vector<T>` batch, e.g: produced by `batch()`, is replaced
+ * by the running accumulations of its items, continuing the
+ * accumulation of the previous batches. Batches of many thousands of items
+ * are split into at most `max_threads` parts scanned concurrently,
+ * which requires `op` to be associative.
+ *
+ * @code
+ * from(amounts) | batch(1 << 20) | parallel_scan(0L, std::plus<long>()) | unbatch() | balances
+ * @endcode
+ *
+ * @param init Initial value of the accumulator, convertible to `T`
+ * @param op Associative operation, `T op(const T&, const T&)`
+ * @param max_threads Maximum number of threads used to scan a batch
+ * @returns A transformation of `std::vector<T>` batches to `std::vector<T>` accumulations
+ */
+template <typename Init, typename Op>
+detail::parallel_scan_stage<Init, Op>
+parallel_scan(Init init, Op op, std::size_t max_threads = std::thread::hardware_concurrency())
+{
+  return detail::parallel_scan_stage<Init, Op>(init, op, max_threads);
+}
+
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_SCAN_HPP
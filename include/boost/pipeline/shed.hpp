@@ -0,0 +1,176 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_SHED_HPP
+#define BOOST_PIPELINE_SHED_HPP
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include <boost/pipeline/queue.hpp>
+#include <boost/pipeline/detail/segment.hpp>
+#include <boost/pipeline/detail/whole_stream.hpp>
+
+namespace boost {
+namespace pipeline {
+
+namespace detail {
+
+/** Overload policy: the downstream queue holds at least `limit` items */
+struct depth_limit
+{
+  template <typename T>
+  bool operator()(const T&, std::size_t depth) const
+  {
+    return depth >= limit;
+  }
+
+  std::size_t limit;
+};
+
+/** Overload policy: the item was created more than `limit` ago */
+template <typename TimestampFn, typename Duration>
+struct age_limit
+{
+  template <typename T>
+  bool operator()(const T& item, std::size_t) const
+  {
+    const auto created = timestamp_fn(item);
+    return decltype(created)::clock::now() - created > limit;
+  }
+
+  TimestampFn timestamp_fn;
+  Duration limit;
+};
+
+template <typename Policy>
+class shed_stage
+{
+  struct counters
+  {
+    counters() :passed(0), dropped(0) {}
+
+    std::atomic<std::uint64_t> passed;
+    std::atomic<std::uint64_t> dropped;
+  };
+
+public:
+  template <typename Plan>
+  using connect_type = n_m_segment<Plan, typename Plan::value_type, void>;
+
+  shed_stage(const Policy& policy, std::size_t sample)
+    :_policy(policy),
+     _sample(sample),
+     _counters(std::make_shared<counters>())
+  {}
+
+  template <typename T>
+  void operator()(queue_front<T>& upstream, queue_back<T>& downstream) const
+  {
+    // whole-stream stage, see pull_or_cancel
+    // overloaded items seen since the last sampled one
+    std::size_t skipped = 0;
+
+    T item;
+    while (pull_or_cancel(upstream, downstream, item))
+    {
+      if (_policy(item, downstream.size()))
+      {
+        if (_sample == 0 || ++skipped < _sample)
+        {
+          ++_counters->dropped;
+          continue;
+        }
+
+        skipped = 0;
+      }
+
+      ++_counters->passed;
+      downstream.push(std::move(item));
+    }
+  }
+
+  /** @returns Number of items passed so far */
+  std::uint64_t passed() const { return _counters->passed; }
+
+  /** @returns Number of items dropped so far */
+  std::uint64_t dropped() const { return _counters->dropped; }
+
+private:
+  Policy _policy;
+  std::size_t _sample;
+  std::shared_ptr<counters> _counters; /**< shared among copies */
+};
+
+} // namespace detail
+
+/**
+ * Creates an overload policy for `shed()`, which is
+ * triggered if the downstream queue holds at least `limit` items.
+ *
+ * @param limit Queue depth considered overloaded
+ */
+inline detail::depth_limit max_depth(std::size_t limit)
+{
+  return detail::depth_limit{limit};
+}
+
+/**
+ * Creates an overload policy for `shed()`, which is
+ * triggered by items created more than `limit` ago.
+ *
+ * @param limit Age considered overloaded, an `std::chrono::duration`
+ * @param timestamp_fn Creation time of an item, `std::chrono::time_point timestamp_fn(const T&)`
+ */
+template <typename Rep, typename Period, typename TimestampFn>
+detail::age_limit<TimestampFn, std::chrono::duration<Rep, Period>>
+max_age(const std::chrono::duration<Rep, Period>& limit, TimestampFn timestamp_fn)
+{
+  return detail::age_limit<TimestampFn, std::chrono::duration<Rep, Period>>{timestamp_fn, limit};
+}
+
+/**
+ * Creates a stage which drops items while the downstream is overloaded,
+ * to keep the latency of the passed items bounded.
+ *
+ * Each item is checked by `policy`, e.g: `max_depth()` or `max_age()`.
+ * Overloaded items are dropped, or if `sample` is positive,
+ * every `sample`th of them is passed. The `passed()` and `dropped()`
+ * counters are shared among the copies of the returned stage:
+ *
+ * @code
+ * auto shedder = shed(max_depth(1000));
+ * auto exec = (from(requests) | shedder | expensive_handler | respond).run(pool);
+ * exec.wait();
+ * std::uint64_t dropped = shedder.dropped();
+ * @endcode
+ *
+ * @param policy `bool policy(const T& item, std::size_t downstream_depth)`,
+ *               returns true if the downstream is overloaded
+ * @param sample If positive, one of `sample` overloaded items is passed
+ * @returns A transformation of `T` items to the not dropped ones
+ */
+template <typename Policy>
+detail::shed_stage<Policy>
+shed(Policy policy, std::size_t sample = 0)
+{
+  return detail::shed_stage<Policy>(policy, sample);
+}
+
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_SHED_HPP
@@ -0,0 +1,461 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_SKETCH_HPP
+#define BOOST_PIPELINE_SKETCH_HPP
+
+#include <vector>
+#include <cmath>
+#include <future>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+
+#include <boost/assert.hpp>
+
+#include <boost/pipeline/queue.hpp>
+#include <boost/pipeline/execution.hpp>
+#include <boost/pipeline/threading.hpp>
+#include <boost/pipeline/detail/hash.hpp>
+#include <boost/pipeline/detail/task.hpp>
+
+namespace boost {
+namespace pipeline {
+
+/**
+ * HyperLogLog sketch, estimates the number of distinct items.
+ *
+ * Takes `2^precision` bytes, the standard error of
+ * the estimate is about `1.04 / sqrt(2^precision)`,
+ * e.g: 0.8% using the default precision of 14.
+ */
+class hyperloglog
+{
+public:
+  /**
+   * @param precision Number of index bits, in [4, 18],
+   *                  if asserts are disabled, out of range values are clamped
+   */
+  explicit hyperloglog(unsigned precision = 14)
+    :_precision(std::min(std::max(precision, 4u), 18u)),
+     _registers(std::size_t(1) << _precision, 0)
+  {
+    BOOST_ASSERT(precision >= 4 && precision <= 18);
+  }
+
+  /** Adds an item hashable by `std::hash` */
+  template <typename T>
+  void add(const T& item)
+  {
+    add_hash(detail::hash_of(item));
+  }
+
+  void add_hash(std::uint64_t hash)
+  {
+    const std::size_t index = static_cast<std::size_t>(hash >> (64 - _precision));
+
+    // rank: position of the first set bit of the remaining bits
+    std::uint64_t rest = hash << _precision;
+    std::uint8_t rank = 1;
+    while (rank <= 64 - _precision && ! (rest & (std::uint64_t(1) << 63)))
+    {
+      rest <<= 1;
+      ++rank;
+    }
+
+    _registers[index] = std::max(_registers[index], rank);
+  }
+
+  /** Adds the items counted by `other`, which must have the same precision */
+  void merge(const hyperloglog& other)
+  {
+    BOOST_ASSERT(_precision == other._precision);
+
+    for (std::size_t i = 0; i < _registers.size(); ++i)
+    {
+      _registers[i] = std::max(_registers[i], other._registers[i]);
+    }
+  }
+
+  /** @returns Estimated number of distinct items */
+  double estimate() const
+  {
+    const double m = static_cast<double>(_registers.size());
+
+    double sum = 0;
+    std::size_t zeros = 0;
+    for (std::uint8_t r : _registers)
+    {
+      sum += std::ldexp(1.0, -r);
+      if (r == 0) { ++zeros; }
+    }
+
+    const double alpha = 0.7213 / (1 + 1.079 / m);
+    const double raw = alpha * m * m / sum;
+
+    // small range correction: linear counting
+    if (raw <= 2.5 * m && zeros)
+    {
+      return m * std::log(m / static_cast<double>(zeros));
+    }
+
+    return raw;
+  }
+
+private:
+  unsigned _precision;
+  std::vector<std::uint8_t> _registers;
+};
+
+/**
+ * Count-Min sketch, estimates the frequency of items.
+ *
+ * The estimate is never less than the real frequency,
+ * it exceeds it by at most `e / width` times the number of items
+ * with a probability of `1 - exp(-depth)`.
+ */
+class count_min_sketch
+{
+public:
+  /**
+   * @param width Number of counters in a row
+   * @param depth Number of rows
+   */
+  count_min_sketch(std::size_t width = 2048, std::size_t depth = 5)
+    :_width(width),
+     _depth(depth),
+     _total(0),
+     _counters(width * depth, 0)
+  {}
+
+  /** Adds `count` occurrences of an item hashable by `std::hash` */
+  template <typename T>
+  void add(const T& item, std::uint64_t count = 1)
+  {
+    const std::uint64_t hash = detail::hash_of(item);
+
+    for (std::size_t row = 0; row < _depth; ++row)
+    {
+      _counters[index_of(hash, row)] += count;
+    }
+
+    _total += count;
+  }
+
+  /** @returns Estimated number of occurrences of `item` */
+  template <typename T>
+  std::uint64_t estimate(const T& item) const
+  {
+    const std::uint64_t hash = detail::hash_of(item);
+
+    std::uint64_t result = std::numeric_limits<std::uint64_t>::max();
+    for (std::size_t row = 0; row < _depth; ++row)
+    {
+      result = std::min(result, _counters[index_of(hash, row)]);
+    }
+
+    return result;
+  }
+
+  /** @returns Number of added items */
+  std::uint64_t total() const { return _total; }
+
+  /** Adds the items counted by `other`, which must have the same dimensions */
+  void merge(const count_min_sketch& other)
+  {
+    BOOST_ASSERT(_width == other._width && _depth == other._depth);
+
+    for (std::size_t i = 0; i < _counters.size(); ++i)
+    {
+      _counters[i] += other._counters[i];
+    }
+
+    _total += other._total;
+  }
+
+private:
+  std::size_t index_of(std::uint64_t hash, std::size_t row) const
+  {
+    // a hash for each row derived from two halves of the hash
+    const std::uint64_t h1 = hash & 0xffffffffu;
+    const std::uint64_t h2 = (hash >> 32) | 1;
+
+    return row * _width + static_cast<std::size_t>((h1 + row * h2) % _width);
+  }
+
+  std::size_t _width;
+  std::size_t _depth;
+  std::uint64_t _total;
+  std::vector<std::uint64_t> _counters;
+};
+
+/**
+ * Quantile sketch with relative error guarantee.
+ *
+ * Positive values are counted in logarithmic buckets,
+ * each bucket covers values within `relative_accuracy`
+ * of its representative value. The number of buckets depends only
+ * on the ratio of the greatest and the least value, e.g:
+ * ~1400 buckets cover latencies from 1ns to 1h at 1% accuracy.
+ * Non-positive values are counted as zeros.
+ */
+class quantile_sketch
+{
+public:
+  /** @param relative_accuracy Maximal relative error of quantiles, in (0, 1) */
+  explicit quantile_sketch(double relative_accuracy = 0.01)
+    :_gamma((1 + relative_accuracy) / (1 - relative_accuracy)),
+     _log_gamma(std::log(_gamma)),
+     _offset(0),
+     _zeros(0),
+     _count(0)
+  {}
+
+  void add(double value)
+  {
+    ++_count;
+
+    if (! (value > 0)) { ++_zeros; return; }
+
+    const int index = static_cast<int>(std::ceil(std::log(value) / _log_gamma));
+    ++bucket(index);
+  }
+
+  /** Adds the values counted by `other`, which must have the same accuracy */
+  void merge(const quantile_sketch& other)
+  {
+    BOOST_ASSERT(_gamma == other._gamma);
+
+    for (std::size_t i = 0; i < other._buckets.size(); ++i)
+    {
+      if (other._buckets[i])
+      {
+        bucket(other._offset + static_cast<int>(i)) += other._buckets[i];
+      }
+    }
+
+    _zeros += other._zeros;
+    _count += other._count;
+  }
+
+  /**
+   * @param q Quantile to be estimated, in [0, 1], e.g: 0.99
+   * @returns Estimated value of `q` quantile, 0 if no value is added
+   */
+  double quantile(double q) const
+  {
+    if (_count == 0) { return 0; }
+
+    const std::uint64_t rank = static_cast<std::uint64_t>(q * static_cast<double>(_count - 1));
+
+    std::uint64_t seen = _zeros;
+    if (rank < seen) { return 0; }
+
+    for (std::size_t i = 0; i < _buckets.size(); ++i)
+    {
+      seen += _buckets[i];
+      if (rank < seen)
+      {
+        const int index = _offset + static_cast<int>(i);
+        return 2 * std::pow(_gamma, index) / (_gamma + 1);
+      }
+    }
+
+    return 2 * std::pow(_gamma, _offset + static_cast<int>(_buckets.size()) - 1) / (_gamma + 1);
+  }
+
+  /** @returns Number of added values */
+  std::uint64_t count() const { return _count; }
+
+private:
+  std::uint64_t& bucket(int index)
+  {
+    if (_buckets.empty())
+    {
+      _offset = index;
+      _buckets.push_back(0);
+    }
+    else if (index < _offset)
+    {
+      _buckets.insert(_buckets.begin(), static_cast<std::size_t>(_offset - index), 0);
+      _offset = index;
+    }
+    else if (index - _offset >= static_cast<int>(_buckets.size()))
+    {
+      _buckets.resize(static_cast<std::size_t>(index - _offset) + 1, 0);
+    }
+
+    return _buckets[static_cast<std::size_t>(index - _offset)];
+  }
+
+  double _gamma;
+  double _log_gamma;
+  int _offset; /**< index of the first bucket */
+  std::vector<std::uint64_t> _buckets;
+  std::uint64_t _zeros;
+  std::uint64_t _count;
+};
+
+namespace detail {
+
+template <typename Input, typename Sketch>
+class summary_task
+{
+public:
+  summary_task(
+    std::promise<void>&& promise,
+    const std::shared_ptr<Sketch>& sketch
+  )
+    :_promise(std::move(promise)),
+     _input(std::make_shared<queue<Input>>()),
+     _sketch(sketch)
+  {}
+
+  void operator()()
+  {
+    queue_front<Input> upstream(*_input);
+
+    Input input;
+    while (upstream.wait_pull(input))
+    {
+      _sketch->add(input);
+    }
+
+    complete(_promise, upstream.error());
+  }
+
+  queue_back<Input> get_queue_back()
+  {
+    return queue_back<Input>(_input);
+  }
+
+private:
+  std::promise<void> _promise;
+  std::shared_ptr<queue<Input>> _input;
+  std::shared_ptr<Sketch> _sketch;
+};
+
+/**
+ * Terminates the parent segment by adding
+ * each of its items to a `Sketch`.
+ */
+template <typename Parent, typename Stage>
+class summary_segment
+{
+public:
+  typedef typename Parent::root_type root_type;
+  typedef typename Parent::value_type input_type;
+  typedef terminated value_type;
+
+  typedef typename Stage::sketch_type sketch_type;
+  typedef summary_task<input_type, sketch_type> task_type;
+
+  summary_segment(const Parent& parent, const Stage& stage)
+    :_parent(parent),
+     _stage(stage)
+  {}
+
+  summary_execution<sketch_type> run(thread_pool& pool)
+  {
+    std::promise<void> promise;
+    auto future = promise.get_future();
+
+    auto sketch = std::make_shared<sketch_type>(_stage.prototype);
+    task_type task(std::move(promise), sketch);
+
+    _parent.run(pool, task.get_queue_back());
+
+    pool.submit(std::move(task));
+
+    return summary_execution<sketch_type>(std::move(future), sketch);
+  }
+
+private:
+  Parent _parent;
+  Stage _stage;
+};
+
+template <typename Sketch>
+struct summary_stage
+{
+  typedef Sketch sketch_type;
+
+  template <typename Plan>
+  using connect_type = summary_segment<Plan, summary_stage>;
+
+  Sketch prototype; /**< empty sketch, copied for each run */
+};
+
+} // namespace detail
+
+/**
+ * Creates a sink which counts the distinct items of its input
+ * using a HyperLogLog sketch.
+ *
+ * The sketch is returned through the execution:
+ *
+ * @code
+ * auto exec = (from(visits) | get_user_id | to_hll()).run(pool);
+ * double users = exec.get().estimate();
+ * @endcode
+ *
+ * Sketches of different pipelines can be merged.
+ *
+ * @param precision Number of index bits, in [4, 18], the sketch takes `2^precision` bytes
+ * @returns A sink of items hashable by `std::hash`
+ */
+inline detail::summary_stage<hyperloglog> to_hll(unsigned precision = 14)
+{
+  return detail::summary_stage<hyperloglog>{hyperloglog(precision)};
+}
+
+/**
+ * Creates a sink which counts the occurrences of its input items
+ * using a Count-Min sketch, e.g: to find heavy hitters.
+ *
+ * @code
+ * auto exec = (from(requests) | get_path | to_count_min()).run(pool);
+ * std::uint64_t hits = exec.get().estimate(std::string("/index.html"));
+ * @endcode
+ *
+ * @param width Number of counters in a row
+ * @param depth Number of rows
+ * @returns A sink of items hashable by `std::hash`
+ */
+inline detail::summary_stage<count_min_sketch>
+to_count_min(std::size_t width = 2048, std::size_t depth = 5)
+{
+  return detail::summary_stage<count_min_sketch>{count_min_sketch(width, depth)};
+}
+
+/**
+ * Creates a sink which estimates the quantiles of its input values.
+ *
+ * @code
+ * auto exec = (from(requests) | get_latency | to_quantiles()).run(pool);
+ * double p99 = exec.get().quantile(0.99);
+ * @endcode
+ *
+ * @param relative_accuracy Maximal relative error of quantiles, in (0, 1)
+ * @returns A sink of items convertible to `double`
+ */
+inline detail::summary_stage<quantile_sketch> to_quantiles(double relative_accuracy = 0.01)
+{
+  return detail::summary_stage<quantile_sketch>{quantile_sketch(relative_accuracy)};
+}
+
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_SKETCH_HPP
@@ -0,0 +1,243 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_SORT_HPP
+#define BOOST_PIPELINE_SORT_HPP
+
+#include <vector>
+#include <future>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+
+#include <boost/pipeline/queue.hpp>
+#include <boost/pipeline/detail/segment.hpp>
+#include <boost/pipeline/detail/whole_stream.hpp>
+#include <boost/pipeline/detail/spill_file.hpp>
+
+namespace boost {
+namespace pipeline {
+
+namespace detail {
+
+template <typename Compare>
+class sort_stage
+{
+public:
+  template <typename Plan>
+  using connect_type = n_m_segment<Plan, typename Plan::value_type, void>;
+
+  sort_stage(const Compare& compare, std::size_t memory_budget)
+    :_compare(compare),
+     _memory_budget(memory_budget)
+  {}
+
+  template <typename T>
+  void operator()(queue_front<T>& upstream, queue_back<T>& downstream) const
+  {
+    // whole-stream stage, see pull_or_cancel
+    sort_items(upstream, downstream, has_spill_codec<T>());
+  }
+
+private:
+  /** Sorts items which can't be spilled in memory */
+  template <typename T>
+  void sort_items(queue_front<T>& upstream, queue_back<T>& downstream, std::false_type) const
+  {
+    std::vector<T> run;
+
+    T item;
+    while (pull_or_cancel(upstream, downstream, item))
+    {
+      run.push_back(std::move(item));
+    }
+
+    if (downstream.is_cancelled()) { return; }
+
+    std::sort(run.begin(), run.end(), _compare);
+    emit(run, downstream);
+  }
+
+  /**
+   * Sorts items using external memory.
+   *
+   * A spill error is thrown from here, and reported by `execution::wait()`.
+   */
+  template <typename T>
+  void sort_items(queue_front<T>& upstream, queue_back<T>& downstream, std::true_type) const
+  {
+    // a run is sorted and spilled in the background
+    // while the next one is collected: both fit in the budget
+    const std::size_t run_size = std::max<std::size_t>(1, _memory_budget / sizeof(T) / 2);
+
+    std::vector<spill_file<T>> spills;
+    std::future<spill_file<T>> pending;
+    std::vector<T> run;
+
+    T item;
+    while (pull_or_cancel(upstream, downstream, item))
+    {
+      run.push_back(std::move(item));
+
+      if (run.size() == run_size)
+      {
+        if (pending.valid()) { spills.push_back(pending.get()); }
+
+        pending = std::async(std::launch::async, &sort_stage::template spill<T>, *this, std::move(run));
+        run.clear();
+      }
+    }
+
+    if (pending.valid()) { spills.push_back(pending.get()); }
+
+    if (downstream.is_cancelled()) { return; }
+
+    std::sort(run.begin(), run.end(), _compare);
+
+    if (spills.empty())
+    {
+      emit(run, downstream);
+    }
+    else
+    {
+      merge(spills, run, downstream);
+    }
+  }
+
+  template <typename T>
+  void emit(std::vector<T>& sorted, queue_back<T>& downstream) const
+  {
+    for (auto& item : sorted)
+    {
+      if (downstream.is_cancelled()) { break; }
+      downstream.push(std::move(item));
+    }
+  }
+
+  template <typename T>
+  spill_file<T> spill(std::vector<T> run) const
+  {
+    std::sort(run.begin(), run.end(), _compare);
+
+    spill_file<T> file;
+    for (const auto& sorted : run) { file.write(sorted); }
+    file.rewind();
+
+    return file;
+  }
+
+  /**
+   * Merges the sorted `spills` and the sorted in-memory `run`
+   * into `downstream`, holding the head of each run only.
+   */
+  template <typename T>
+  void merge(
+    std::vector<spill_file<T>>& spills,
+    std::vector<T>& run,
+    queue_back<T>& downstream
+  ) const
+  {
+    typedef std::pair<T, std::size_t> head; // item, index of the run
+
+    // min-heap by item
+    auto greater = [this](const head& a, const head& b)
+    {
+      return _compare(b.first, a.first);
+    };
+
+    std::vector<head> heads;
+    heads.reserve(spills.size() + 1);
+
+    T item;
+    for (std::size_t i = 0; i < spills.size(); ++i)
+    {
+      if (spills[i].read(item)) { heads.push_back(head(std::move(item), i)); }
+    }
+
+    // the in-memory run is identified by the index past the spills
+    auto next_in_memory = run.begin();
+    if (next_in_memory != run.end())
+    {
+      heads.push_back(head(std::move(*next_in_memory++), spills.size()));
+    }
+
+    std::make_heap(heads.begin(), heads.end(), greater);
+
+    while (! heads.empty() && ! downstream.is_cancelled())
+    {
+      std::pop_heap(heads.begin(), heads.end(), greater);
+      head& top = heads.back();
+
+      downstream.push(std::move(top.first));
+
+      bool has_next = false;
+      if (top.second < spills.size())
+      {
+        has_next = spills[top.second].read(top.first);
+      }
+      else if (next_in_memory != run.end())
+      {
+        top.first = std::move(*next_in_memory++);
+        has_next = true;
+      }
+
+      if (has_next)
+      {
+        std::push_heap(heads.begin(), heads.end(), greater);
+      }
+      else
+      {
+        heads.pop_back();
+      }
+    }
+  }
+
+  Compare _compare;
+  std::size_t _memory_budget;
+};
+
+} // namespace detail
+
+/**
+ * Creates a stage which sorts its input using external memory.
+ *
+ * Items are collected into runs, each run takes half of `memory_budget`.
+ * Full runs are sorted and spilled to a temporary file in the background
+ * while the next run is collected. When the upstream gets closed,
+ * the runs are merged and streamed to the downstream.
+ * If the input fits in a single run, no file is created.
+ *
+ * The budget is estimated using `sizeof(T)`, memory held by the items
+ * (e.g: the buffer of a string) isn't accounted. Only trivially copyable
+ * items and `std::basic_string`s are spilled, other items are sorted
+ * in memory regardless of the budget. If a spill file can't be
+ * written, `execution::wait()` throws `std::runtime_error`.
+ *
+ * @code
+ * from(events) | sort(by_timestamp, 256 << 20) | replay
+ * @endcode
+ *
+ * @param compare Strict weak ordering, `bool compare(const T&, const T&)`
+ * @param memory_budget Number of bytes the buffered items might take
+ * @returns A transformation of `T` items to the same items, sorted
+ */
+template <typename Compare>
+detail::sort_stage<Compare>
+sort(Compare compare, std::size_t memory_budget = std::size_t(64) << 20)
+{
+  return detail::sort_stage<Compare>(compare, memory_budget);
+}
+
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_SORT_HPP
@@ -0,0 +1,137 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_TAKE_HPP
+#define BOOST_PIPELINE_TAKE_HPP
+
+#include <cstddef>
+#include <utility>
+
+#include <boost/pipeline/queue.hpp>
+#include <boost/pipeline/detail/segment.hpp>
+
+namespace boost {
+namespace pipeline {
+
+namespace detail {
+
+class take_stage
+{
+public:
+  template <typename Plan>
+  using connect_type = n_m_segment<Plan, typename Plan::value_type, void>;
+
+  explicit take_stage(std::size_t n)
+    :_n(n)
+  {}
+
+  template <typename T>
+  void operator()(queue_front<T>& upstream, queue_back<T>& downstream) const
+  {
+    std::size_t taken = 0;
+
+    T item;
+    while (taken < _n && ! downstream.is_cancelled() && upstream.wait_pull(item))
+    {
+      downstream.push(std::move(item));
+      ++taken;
+    }
+
+    upstream.cancel();
+  }
+
+private:
+  std::size_t _n;
+};
+
+template <typename Predicate>
+class take_while_stage
+{
+public:
+  template <typename Plan>
+  using connect_type = n_m_segment<Plan, typename Plan::value_type, void>;
+
+  explicit take_while_stage(const Predicate& predicate)
+    :_predicate(predicate)
+  {}
+
+  template <typename T>
+  void operator()(queue_front<T>& upstream, queue_back<T>& downstream) const
+  {
+    T item;
+    while (! downstream.is_cancelled() && upstream.wait_pull(item))
+    {
+      if (! _predicate(item)) { break; }
+
+      downstream.push(std::move(item));
+    }
+
+    upstream.cancel();
+  }
+
+private:
+  Predicate _predicate;
+};
+
+} // namespace detail
+
+/**
+ * Creates a stage which passes the first `n` items of its input,
+ * then cancels the upstream.
+ *
+ * The output is closed right away, the downstream segments finish
+ * without waiting for the upstream to stop.
+ *
+ * Cancellation is propagated upstream: the transformations and the stages
+ * of the library stop at their next item, range and queue sources stop reading,
+ * `tee()` and `route()` stop once every branch is cancelled.
+ * Generators should check `queue_back::is_cancelled()`
+ * to learn that their items aren't needed anymore:
+ *
+ * @code
+ * void naturals(queue_back<int>& downstream)
+ * {
+ *   for (int i = 0; ! downstream.is_cancelled(); ++i) { downstream.push(i); }
+ * }
+ *
+ * auto exec = (from(naturals) | expensive_check | take(10) | preview).run(pool);
+ * @endcode
+ *
+ * @param n Number of items to pass
+ * @returns A transformation of `T` items to the first `n` of them
+ */
+inline detail::take_stage take(std::size_t n)
+{
+  return detail::take_stage(n);
+}
+
+/**
+ * Creates a stage which passes the items of its input
+ * while `predicate` holds, then cancels the upstream.
+ *
+ * The first item not satisfying `predicate` is dropped,
+ * the cancellation is propagated as described at `take()`.
+ *
+ * @param predicate `bool predicate(const T&)`
+ * @returns A transformation of `T` items to the leading items satisfying `predicate`
+ */
+template <typename Predicate>
+detail::take_while_stage<Predicate>
+take_while(Predicate predicate)
+{
+  return detail::take_while_stage<Predicate>(predicate);
+}
+
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_TAKE_HPP
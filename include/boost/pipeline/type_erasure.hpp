@@ -322,6 +322,9 @@ class segment<Input, terminated>
   typedef detail::upstream_proxy<Input> proxy;
 
 public:
+  typedef Input      root_type;
+  typedef terminated value_type;
+
   /** Copy constructor */
   segment(const segment<Input, terminated>& rhs)
     :_impl(rhs._impl->clone())
@@ -367,6 +370,11 @@ public:
   }
 
 private:
+  friend void detail::connect_to<>(
+    segment<Input, terminated>&,
+    detail::runnable_concept<Input>&
+  ); // don't move this above root_type typedef
+
   std::unique_ptr<detail::segment_concept<Input, terminated>> _impl;
 };
 
@@ -0,0 +1,324 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#ifndef BOOST_PIPELINE_WINDOW_HPP
+#define BOOST_PIPELINE_WINDOW_HPP
+
+#include <vector>
+#include <deque>
+#include <cstddef>
+#include <algorithm>
+
+#include <boost/assert.hpp>
+
+#include <boost/pipeline/queue.hpp>
+#include <boost/pipeline/detail/segment.hpp>
+#include <boost/pipeline/detail/whole_stream.hpp>
+
+namespace boost {
+namespace pipeline {
+
+namespace detail {
+
+/**
+ * FIFO of items maintaining the aggregate of its content
+ * using the two-stacks algorithm.
+ *
+ * `Op` must be associative, but not necessarily invertible or commutative.
+ * Each operation takes amortized O(1) calls of `Op`.
+ */
+template <typename T, typename Op>
+class two_stacks
+{
+public:
+  explicit two_stacks(const Op& op)
+    :_op(op)
+  {}
+
+  void push(const T& item)
+  {
+    _back_aggregate = (_back.empty()) ? item : _op(_back_aggregate, item);
+    _back.push_back(item);
+  }
+
+  void pop()
+  {
+    if (_front.empty())
+    {
+      // flip: _front stores the aggregate of each item
+      // and the items pushed after it, the oldest item is on top
+      for (auto it = _back.rbegin(); it != _back.rend(); ++it)
+      {
+        _front.push_back((_front.empty()) ? *it : _op(*it, _front.back()));
+      }
+
+      _back.clear();
+    }
+
+    _front.pop_back();
+  }
+
+  /** @pre `size() > 0` */
+  T aggregate() const
+  {
+    if (_front.empty()) { return _back_aggregate; }
+    if (_back.empty())  { return _front.back(); }
+
+    return _op(_front.back(), _back_aggregate);
+  }
+
+  std::size_t size() const
+  {
+    return _front.size() + _back.size();
+  }
+
+private:
+  Op _op;
+  std::vector<T> _front;
+  std::vector<T> _back;
+  T _back_aggregate;
+};
+
+/**
+ * FIFO of items maintaining the aggregate of its content
+ * by applying `Op` on push and `Inverse` on pop.
+ */
+template <typename T, typename Op, typename Inverse>
+class invertible_aggregate
+{
+public:
+  invertible_aggregate(const Op& op, const Inverse& inverse)
+    :_op(op),
+     _inverse(inverse)
+  {}
+
+  void push(const T& item)
+  {
+    _aggregate = (_items.empty()) ? item : _op(_aggregate, item);
+    _items.push_back(item);
+  }
+
+  void pop()
+  {
+    _aggregate = _inverse(_aggregate, _items.front());
+    _items.pop_front();
+  }
+
+  /** @pre `size() > 0` */
+  T aggregate() const
+  {
+    return _aggregate;
+  }
+
+  std::size_t size() const
+  {
+    return _items.size();
+  }
+
+private:
+  Op _op;
+  Inverse _inverse;
+  std::deque<T> _items;
+  T _aggregate;
+};
+
+template <typename Op>
+class tumbling_window_stage
+{
+public:
+  template <typename Plan>
+  using connect_type = n_m_segment<Plan, typename Plan::value_type, void>;
+
+  /** A `size` of 0 is taken as 1 */
+  tumbling_window_stage(std::size_t size, const Op& op)
+    :_size(std::max<std::size_t>(size, 1)),
+     _op(op)
+  {}
+
+  template <typename T>
+  void operator()(queue_front<T>& upstream, queue_back<T>& downstream) const
+  {
+    T aggregate;
+    if (! upstream.wait_pull(aggregate)) { return; }
+
+    T item;
+    std::size_t count = 1;
+
+    while (count < _size && upstream.wait_pull(item))
+    {
+      aggregate = _op(aggregate, item);
+      ++count;
+    }
+
+    downstream.push(std::move(aggregate));
+  }
+
+private:
+  std::size_t _size;
+  Op _op;
+};
+
+template <typename Aggregator>
+class sliding_window_stage
+{
+public:
+  template <typename Plan>
+  using connect_type = n_m_segment<Plan, typename Plan::value_type, void>;
+
+  /** A `size` or `step` of 0 is taken as 1 */
+  sliding_window_stage(std::size_t size, std::size_t step, const Aggregator& aggregator)
+    :_size(std::max<std::size_t>(size, 1)),
+     _step(std::max<std::size_t>(step, 1)),
+     _aggregator(aggregator)
+  {}
+
+  template <typename T>
+  void operator()(queue_front<T>& upstream, queue_back<T>& downstream) const
+  {
+    // whole-stream stage, see pull_or_cancel
+    auto window = _aggregator.template make<T>();
+    std::size_t since_last = 0;
+
+    T item;
+    while (pull_or_cancel(upstream, downstream, item))
+    {
+      window.push(item);
+      if (window.size() > _size) { window.pop(); }
+
+      ++since_last;
+
+      if (window.size() == _size && since_last >= _step)
+      {
+        downstream.push(window.aggregate());
+        since_last = 0;
+      }
+    }
+  }
+
+private:
+  std::size_t _size;
+  std::size_t _step;
+  Aggregator _aggregator;
+};
+
+template <typename Op>
+struct two_stacks_aggregator
+{
+  template <typename T>
+  two_stacks<T, Op> make() const
+  {
+    return two_stacks<T, Op>(op);
+  }
+
+  Op op;
+};
+
+template <typename Op, typename Inverse>
+struct invertible_aggregator
+{
+  template <typename T>
+  invertible_aggregate<T, Op, Inverse> make() const
+  {
+    return invertible_aggregate<T, Op, Inverse>(op, inverse);
+  }
+
+  Op op;
+  Inverse inverse;
+};
+
+} // namespace detail
+
+/**
+ * Creates a stage which aggregates every `size` items into one.
+ *
+ * Items of the window are combined using `op` as they arrive,
+ * only the aggregate is stored. The last window might be smaller
+ * if the upstream gets closed.
+ *
+ * @code
+ * from(bytes_per_request) | tumbling_window(1000, std::plus<std::size_t>()) | report
+ * @endcode
+ *
+ * @param size Number of items in a window, must be positive,
+ *             if asserts are disabled, 0 is taken as 1
+ * @param op Associative binary operation, `T op(const T&, const T&)`
+ * @returns A transformation of `T` items to `T` aggregates
+ */
+template <typename Op>
+detail::tumbling_window_stage<Op>
+tumbling_window(std::size_t size, Op op)
+{
+  BOOST_ASSERT(size > 0);
+
+  return detail::tumbling_window_stage<Op>(size, op);
+}
+
+/**
+ * Creates a stage which aggregates the last `size` items
+ * each time `step` new items arrived.
+ *
+ * The window is maintained using the two-stacks algorithm:
+ * `op` is called amortized O(1) times for each item, it doesn't have
+ * to be invertible or commutative. Windows are emitted only if full,
+ * i.e: there is no output if less than `size` items arrive.
+ *
+ * @code
+ * auto max = [](int a, int b) { return std::max(a, b); };
+ * from(latencies) | sliding_window(60, 10, max) | report
+ * @endcode
+ *
+ * @param size Number of items in a window, must be positive,
+ *             if asserts are disabled, 0 is taken as 1
+ * @param step Number of items between two windows, must be positive,
+ *             if asserts are disabled, 0 is taken as 1
+ * @param op Associative binary operation, `T op(const T&, const T&)`
+ * @returns A transformation of `T` items to `T` aggregates
+ */
+template <typename Op>
+detail::sliding_window_stage<detail::two_stacks_aggregator<Op>>
+sliding_window(std::size_t size, std::size_t step, Op op)
+{
+  BOOST_ASSERT(size > 0 && step > 0);
+
+  typedef detail::two_stacks_aggregator<Op> aggregator;
+  return detail::sliding_window_stage<aggregator>(size, step, aggregator{op});
+}
+
+/**
+ * Creates a stage which aggregates the last `size` items
+ * each time `step` new items arrived, using an invertible operation.
+ *
+ * The aggregate is updated using `op` when an item enters the window
+ * and `inverse` when an item leaves it, e.g: `std::plus` and `std::minus`.
+ *
+ * @param size Number of items in a window, must be positive,
+ *             if asserts are disabled, 0 is taken as 1
+ * @param step Number of items between two windows, must be positive,
+ *             if asserts are disabled, 0 is taken as 1
+ * @param op Associative binary operation, `T op(const T&, const T&)`
+ * @param inverse Inverse of `op`: `inverse(op(a, b), a) == b`
+ * @returns A transformation of `T` items to `T` aggregates
+ */
+template <typename Op, typename Inverse>
+detail::sliding_window_stage<detail::invertible_aggregator<Op, Inverse>>
+sliding_window(std::size_t size, std::size_t step, Op op, Inverse inverse)
+{
+  BOOST_ASSERT(size > 0 && step > 0);
+
+  typedef detail::invertible_aggregator<Op, Inverse> aggregator;
+  return detail::sliding_window_stage<aggregator>(size, step, aggregator{op, inverse});
+}
+
+} // namespace pipeline
+} // namespace boost
+
+#endif // BOOST_PIPELINE_WINDOW_HPP
@@ -0,0 +1,177 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <future>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+
+#include <boost/pipeline.hpp>
+
+#define BOOST_TEST_MODULE Async
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::pipeline;
+
+// slower for smaller inputs
+std::future<int> slow_square(int i)
+{
+  return std::async(std::launch::async, [i]()
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20 - i));
+    return i * i;
+  });
+}
+
+// number of running and peak number of concurrent calls of counted_square
+std::atomic<int> running(0);
+std::atomic<int> peak(0);
+
+std::future<int> counted_square(int i)
+{
+  return std::async(std::launch::async, [i]()
+  {
+    const int now = ++running;
+
+    int previous = peak;
+    while (previous < now && ! peak.compare_exchange_weak(previous, now)) {}
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    --running;
+    return i * i;
+  });
+}
+
+std::future<int> square_but_five(int i)
+{
+  return std::async(std::launch::async, [i]()
+  {
+    if (i == 5) { throw std::runtime_error("five"); }
+    return i * i;
+  });
+}
+
+void naturals(queue_back<int>& downstream)
+{
+  for (int i = 0; ! downstream.is_cancelled(); ++i)
+  {
+    downstream.push(i);
+  }
+}
+
+std::vector<int> squares(int n)
+{
+  std::vector<int> result;
+  for (int i = 0; i < n; ++i) { result.push_back(i * i); }
+  return result;
+}
+
+BOOST_AUTO_TEST_CASE(AsyncMapOrdered)
+{
+  std::vector<int> input(20);
+  std::iota(input.begin(), input.end(), 0);
+
+  std::vector<int> output;
+
+  thread_pool pool{2};
+
+  auto exec = (from(input) | async_map(slow_square, 10) | output).run(pool);
+  exec.wait();
+
+  std::vector<int> expected = squares(20);
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+}
+
+BOOST_AUTO_TEST_CASE(AsyncMapInFlight)
+{
+  std::vector<int> input(50);
+  std::iota(input.begin(), input.end(), 0);
+
+  std::vector<int> output;
+
+  thread_pool pool{2};
+
+  peak = 0;
+
+  auto exec = (from(input) | async_map(counted_square, 4) | output).run(pool);
+  exec.wait();
+
+  BOOST_CHECK_EQUAL(output.size(), 50u);
+
+  // calls overlap, but never more than max_in_flight
+  BOOST_CHECK(peak > 1);
+  BOOST_CHECK(peak <= 4);
+}
+
+BOOST_AUTO_TEST_CASE(AsyncMapCancelledByTake)
+{
+  std::vector<int> output;
+
+  thread_pool pool{4};
+
+  // would never terminate without cancellation
+  auto exec = (from(naturals) | async_map(counted_square, 4) | take(5) | output).run(pool);
+  exec.wait();
+
+  std::vector<int> expected = squares(5);
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+}
+
+BOOST_AUTO_TEST_CASE(AsyncMapFailure)
+{
+  std::vector<int> output;
+
+  thread_pool pool{3};
+
+  // would never terminate if the failure didn't cancel the upstream
+  auto exec = (from(naturals) | async_map(square_but_five, 4) | output).run(pool);
+  BOOST_CHECK_THROW(exec.wait(), std::runtime_error);
+
+  std::vector<int> expected = squares(5);
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+}
+
+BOOST_AUTO_TEST_CASE(AsyncMapUnordered)
+{
+  std::vector<int> input(10);
+  std::iota(input.begin(), input.end(), 0);
+
+  std::vector<int> output;
+
+  thread_pool pool{2};
+
+  auto exec = (from(input) | async_map(slow_square, 10, false) | output).run(pool);
+  exec.wait();
+
+  BOOST_CHECK(output.front() != 0);
+
+  std::sort(output.begin(), output.end());
+
+  std::vector<int> expected = squares(10);
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+}
@@ -0,0 +1,153 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#include <vector>
+#include <chrono>
+#include <numeric>
+#include <thread>
+#include <algorithm>
+
+#include <boost/pipeline.hpp>
+
+#define BOOST_TEST_MODULE Batch
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::pipeline;
+
+BOOST_AUTO_TEST_CASE(BatchBySize)
+{
+  std::vector<int> input(10);
+  std::iota(input.begin(), input.end(), 0);
+
+  std::vector<std::vector<int>> output;
+
+  thread_pool pool{2};
+
+  auto exec = (from(input) | batch(4) | output).run(pool);
+  exec.wait();
+
+  BOOST_REQUIRE_EQUAL(output.size(), 3u);
+  BOOST_CHECK(output[0] == std::vector<int>({0, 1, 2, 3}));
+  BOOST_CHECK(output[1] == std::vector<int>({4, 5, 6, 7}));
+  BOOST_CHECK(output[2] == std::vector<int>({8, 9}));
+}
+
+BOOST_AUTO_TEST_CASE(BatchByTime)
+{
+  queue<int> input;
+  std::vector<std::vector<int>> output;
+
+  thread_pool pool{3};
+
+  auto exec = (input | batch(100, std::chrono::milliseconds(10)) | output).run(pool);
+
+  input.push(1);
+  input.push(2);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  input.push(3);
+  input.close();
+
+  exec.wait();
+
+  BOOST_REQUIRE_EQUAL(output.size(), 2u);
+  BOOST_CHECK(output[0] == std::vector<int>({1, 2}));
+  BOOST_CHECK(output[1] == std::vector<int>({3}));
+}
+
+BOOST_AUTO_TEST_CASE(Unbatch)
+{
+  std::vector<int> input(10);
+  std::iota(input.begin(), input.end(), 0);
+
+  std::vector<int> output;
+
+  thread_pool pool{3};
+
+  auto exec = (from(input) | batch(3) | unbatch() | output).run(pool);
+  exec.wait();
+
+  BOOST_CHECK(input == output);
+}
+
+BOOST_AUTO_TEST_CASE(BatchOpenSegment)
+{
+  std::vector<int> input{1, 2, 3, 4, 5};
+  std::vector<int> output;
+
+  auto sum = [](const std::vector<int>& items)
+  {
+    return std::accumulate(items.begin(), items.end(), 0);
+  };
+
+  auto batch_2 = batch(2);
+  auto sums = make(batch_2) | sum;
+
+  thread_pool pool{3};
+
+  auto exec = (from(input) | sums | output).run(pool);
+  exec.wait();
+
+  BOOST_CHECK(output == std::vector<int>({3, 7, 5}));
+}
+
+BOOST_AUTO_TEST_CASE(AdaptiveBatchGrows)
+{
+  std::vector<int> input(200);
+  std::iota(input.begin(), input.end(), 0);
+
+  std::vector<int> output;
+  std::size_t largest = 0;
+
+  auto slow_consumer = [&](const std::vector<int>& items)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    largest = std::max(largest, items.size());
+    output.insert(output.end(), items.begin(), items.end());
+  };
+
+  auto batcher = adaptive_batch(16);
+
+  thread_pool pool{3};
+
+  auto exec = (from(input) | batcher | slow_consumer).run(pool);
+  exec.wait();
+
+  BOOST_CHECK(input == output);
+  BOOST_CHECK(largest > 1);
+  BOOST_CHECK(largest <= 16);
+}
+
+BOOST_AUTO_TEST_CASE(AdaptiveBatchIdle)
+{
+  queue<int> input;
+  std::vector<std::vector<int>> output;
+
+  auto batcher = adaptive_batch(16);
+
+  thread_pool pool{3};
+
+  auto exec = (input | batcher | output).run(pool);
+
+  for (int i = 0; i < 5; ++i)
+  {
+    input.push(i);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+
+  input.close();
+  exec.wait();
+
+  BOOST_CHECK_EQUAL(output.size(), 5u);
+  BOOST_CHECK_EQUAL(batcher.batch_size(), 1u);
+}
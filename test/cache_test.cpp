@@ -0,0 +1,98 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#include <vector>
+#include <string>
+#include <atomic>
+
+#include <boost/pipeline.hpp>
+#include <boost/pipeline/detail/clock_cache.hpp>
+
+#define BOOST_TEST_MODULE Cache
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::pipeline;
+
+std::atomic<int> calls(0);
+
+std::string get_name(int uid)
+{
+  ++calls;
+  return "user" + std::to_string(uid);
+}
+
+BOOST_AUTO_TEST_CASE(ClockCache)
+{
+  detail::clock_cache<int, int> cache(2);
+  int value = 0;
+
+  cache.insert(1, 10);
+  cache.insert(2, 20);
+
+  BOOST_CHECK(cache.find(1, value));
+  BOOST_CHECK_EQUAL(value, 10);
+
+  // 1 is referenced, 2 is evicted
+  cache.insert(3, 30);
+
+  BOOST_CHECK(cache.find(1, value));
+  BOOST_CHECK(cache.find(2, value) == false);
+  BOOST_CHECK(cache.find(3, value));
+  BOOST_CHECK_EQUAL(value, 30);
+}
+
+BOOST_AUTO_TEST_CASE(Cached)
+{
+  calls = 0;
+
+  std::vector<int> input;
+  for (int i = 0; i < 1000; ++i) { input.push_back(i % 10); }
+
+  std::vector<std::string> output;
+
+  thread_pool pool{2};
+
+  auto get_name_cached = cached(get_name, 16);
+  auto exec = (from(input) | get_name_cached | output).run(pool);
+  exec.wait();
+
+  BOOST_REQUIRE_EQUAL(output.size(), input.size());
+  BOOST_CHECK_EQUAL(output[999], "user9");
+
+  BOOST_CHECK_EQUAL(calls, 10);
+  BOOST_CHECK_EQUAL(get_name_cached.misses(), 10u);
+  BOOST_CHECK_EQUAL(get_name_cached.hits(), 990u);
+}
+
+BOOST_AUTO_TEST_CASE(CachedShared)
+{
+  std::vector<int> input;
+  for (int i = 0; i < 1000; ++i) { input.push_back(i % 10); }
+
+  std::vector<int> output_a;
+  std::vector<int> output_b;
+
+  thread_pool pool{4};
+
+  auto square = cached([](int i) { return i * i; }, 16);
+
+  auto exec_a = (from(input) | square | output_a).run(pool);
+  auto exec_b = (from(input) | square | output_b).run(pool);
+
+  exec_a.wait();
+  exec_b.wait();
+
+  BOOST_CHECK_EQUAL(output_a[999], 81);
+  BOOST_CHECK_EQUAL(output_b[999], 81);
+  BOOST_CHECK_EQUAL(square.hits() + square.misses(), 2000u);
+  BOOST_CHECK_LE(square.misses(), 20u);
+}
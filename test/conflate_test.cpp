@@ -0,0 +1,84 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#include <map>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <utility>
+
+#include <boost/pipeline.hpp>
+
+#define BOOST_TEST_MODULE Conflate
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::pipeline;
+
+typedef std::pair<std::string, int> quote; // symbol, price
+
+std::string symbol_of(const quote& q) { return q.first; }
+
+BOOST_AUTO_TEST_CASE(ConflationBuffer)
+{
+  detail::conflation_buffer<std::string, int> buffer;
+
+  BOOST_CHECK(buffer.put("a", 1));
+  BOOST_CHECK(buffer.put("b", 2));
+  BOOST_CHECK(buffer.put("a", 3) == false);
+
+  BOOST_CHECK_EQUAL(buffer.size(), 2u);
+
+  // "a" keeps its position
+  BOOST_CHECK_EQUAL(buffer.pop(), 3);
+  BOOST_CHECK_EQUAL(buffer.pop(), 2);
+  BOOST_CHECK(buffer.empty());
+}
+
+BOOST_AUTO_TEST_CASE(Conflate)
+{
+  const std::vector<std::string> symbols{"A", "B", "C"};
+
+  std::vector<quote> input;
+  for (int price = 0; price < 300; ++price)
+  {
+    input.push_back(quote(symbols[price % 3], price));
+  }
+
+  auto slow_reprice = [](const quote& q)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return q;
+  };
+
+  std::vector<quote> output;
+
+  thread_pool pool{4};
+
+  auto exec = (from(input) | conflate(symbol_of) | slow_reprice | output).run(pool);
+  exec.wait();
+
+  BOOST_CHECK(output.size() < input.size());
+
+  // updates of a symbol keep their order, the latest one is always delivered
+  std::map<std::string, int> latest;
+  for (const quote& q : output)
+  {
+    auto found = latest.find(q.first);
+    if (found != latest.end()) { BOOST_CHECK(found->second < q.second); }
+    latest[q.first] = q.second;
+  }
+
+  BOOST_CHECK_EQUAL(latest["A"], 297);
+  BOOST_CHECK_EQUAL(latest["B"], 298);
+  BOOST_CHECK_EQUAL(latest["C"], 299);
+}
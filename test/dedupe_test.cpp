@@ -0,0 +1,107 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include <boost/pipeline.hpp>
+#include <boost/pipeline/detail/bloom_filter.hpp>
+#include <boost/pipeline/detail/hash.hpp>
+
+#define BOOST_TEST_MODULE Dedupe
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::pipeline;
+
+int identity(int i) { return i; }
+
+BOOST_AUTO_TEST_CASE(BloomFilter)
+{
+  detail::blocked_bloom_filter filter(10000, 0.01);
+
+  for (std::uint64_t i = 0; i < 10000; ++i)
+  {
+    filter.insert(detail::mix_hash(i));
+  }
+
+  for (std::uint64_t i = 0; i < 10000; ++i)
+  {
+    BOOST_CHECK(filter.contains(detail::mix_hash(i)));
+  }
+
+  std::size_t false_positives = 0;
+  for (std::uint64_t i = 10000; i < 110000; ++i)
+  {
+    if (filter.contains(detail::mix_hash(i))) { ++false_positives; }
+  }
+
+  BOOST_CHECK_LT(false_positives, 2000u);
+}
+
+BOOST_AUTO_TEST_CASE(BloomFilterClamped)
+{
+  const std::size_t regular = detail::blocked_bloom_filter(10000, 0.01).size_in_bytes();
+
+  // out of range rates don't collapse the filter to a single block
+  BOOST_CHECK_GT(detail::blocked_bloom_filter(10000, 0.0).size_in_bytes(), regular);
+  BOOST_CHECK_GT(detail::blocked_bloom_filter(10000, -1.0).size_in_bytes(), regular);
+  BOOST_CHECK_GT(detail::blocked_bloom_filter(10000, 1.0).size_in_bytes(), 32u);
+  BOOST_CHECK_GT(detail::blocked_bloom_filter(10000, 2.0).size_in_bytes(), 32u);
+}
+
+BOOST_AUTO_TEST_CASE(DedupeExact)
+{
+  std::vector<std::string> input{"a", "b", "a", "c", "b", "d", "a"};
+  std::vector<std::string> output;
+
+  thread_pool pool{2};
+
+  auto exec = (
+      from(input)
+    | dedupe([](const std::string& s) { return s; })
+    | output
+  ).run(pool);
+
+  exec.wait();
+
+  std::vector<std::string> expected{"a", "b", "c", "d"};
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+}
+
+BOOST_AUTO_TEST_CASE(DedupeBloom)
+{
+  std::vector<int> input;
+  for (int round = 0; round < 3; ++round)
+  {
+    for (int i = 0; i < 10000; ++i) { input.push_back(i); }
+  }
+
+  std::vector<int> output;
+
+  thread_pool pool{2};
+
+  auto exec = (from(input) | dedupe(identity, 10000, 0.01) | output).run(pool);
+  exec.wait();
+
+  // no duplicates, only a few false positives
+  BOOST_CHECK_LE(output.size(), 10000u);
+  BOOST_CHECK_GT(output.size(), 9500u);
+
+  for (std::size_t i = 1; i < output.size(); ++i)
+  {
+    BOOST_CHECK_LT(output[i - 1], output[i]);
+  }
+}
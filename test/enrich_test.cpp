@@ -0,0 +1,121 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#include <map>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <utility>
+
+#include <boost/pipeline.hpp>
+
+#define BOOST_TEST_MODULE Enrich
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::pipeline;
+
+typedef std::pair<std::string, int> person; // name, department id
+
+int department_of(const person& p) { return p.second; }
+
+std::string describe(const person& p, const std::string* department)
+{
+  return p.first + "@" + ((department) ? *department : "?");
+}
+
+BOOST_AUTO_TEST_CASE(LookupTable)
+{
+  std::map<int, std::string> departments{{1, "Sales"}, {2, "IT"}};
+  lookup_table<int, std::string> table(departments);
+
+  auto before = table.snapshot();
+
+  table.reset(std::map<int, std::string>{{1, "Marketing"}});
+
+  BOOST_CHECK_EQUAL(*before->find(1), "Sales");
+  BOOST_CHECK_EQUAL(*before->find(2), "IT");
+
+  BOOST_CHECK_EQUAL(*table.snapshot()->find(1), "Marketing");
+  BOOST_CHECK(table.snapshot()->find(2) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(LookupTableReader)
+{
+  lookup_table<int, std::string> table(std::map<int, std::string>{{1, "Sales"}});
+  lookup_table<int, std::string>::reader reader(table);
+
+  const auto* first = &reader.get();
+  BOOST_CHECK_EQUAL(*reader.get().find(1), "Sales");
+  BOOST_CHECK(&reader.get() == first);
+
+  // refreshed after reset
+  table.reset(std::map<int, std::string>{{1, "IT"}});
+  BOOST_CHECK_EQUAL(*reader.get().find(1), "IT");
+}
+
+BOOST_AUTO_TEST_CASE(Enrich)
+{
+  std::vector<std::pair<int, std::string>> departments{{1, "Sales"}, {2, "IT"}};
+  lookup_table<int, std::string> table(departments);
+
+  std::vector<person> input{{"Alice", 1}, {"Bob", 2}, {"Eve", 3}};
+  std::vector<std::string> output;
+
+  thread_pool pool{2};
+
+  auto exec = (from(input) | enrich(table, department_of, describe) | output).run(pool);
+  exec.wait();
+
+  std::vector<std::string> expected{"Alice@Sales", "Bob@IT", "Eve@?"};
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+}
+
+BOOST_AUTO_TEST_CASE(EnrichHotSwap)
+{
+  lookup_table<int, std::string> table;
+  std::atomic<int> processed(0);
+
+  auto generate = [&table, &processed](queue_back<person>& downstream)
+  {
+    downstream.push(person("Alice", 1));
+
+    // wait until Alice is processed
+    while (processed == 0) { std::this_thread::yield(); }
+
+    table.reset(std::map<int, std::string>{{1, "Sales"}});
+
+    downstream.push(person("Bob", 1));
+  };
+
+  auto count = [&processed](const std::string& description)
+  {
+    ++processed;
+    return description;
+  };
+
+  std::vector<std::string> output;
+
+  thread_pool pool{3};
+
+  auto exec = (from<person>(generate) | enrich(table, department_of, describe) | count | output).run(pool);
+  exec.wait();
+
+  std::vector<std::string> expected{"Alice@?", "Bob@Sales"};
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+}
@@ -0,0 +1,141 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+#include <boost/pipeline.hpp>
+
+#define BOOST_TEST_MODULE FanIn
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::pipeline;
+
+int negate(int i) { return -i; }
+
+void generate(queue_back<int>& downstream)
+{
+  for (int i = 1000; i < 1100; ++i)
+  {
+    downstream.push(i);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Merge)
+{
+  std::vector<int> a(500);
+  std::iota(a.begin(), a.end(), 0);
+
+  std::vector<int> b(a);
+  std::vector<int> output;
+
+  thread_pool pool{6};
+
+  auto exec = (merge(from(a), from(b) | negate, from(generate)) | output).run(pool);
+  exec.wait();
+
+  BOOST_REQUIRE_EQUAL(output.size(), 1100u);
+
+  // order of items of the same input is kept
+  std::vector<int> positive;
+  std::copy_if(output.begin(), output.end(), std::back_inserter(positive),
+    [](int i) { return i > 0 && i < 1000; }
+  );
+  BOOST_CHECK(std::is_sorted(positive.begin(), positive.end()));
+
+  std::sort(output.begin(), output.end());
+  BOOST_CHECK_EQUAL(output.front(), -499);
+  BOOST_CHECK_EQUAL(output.back(), 1099);
+}
+
+BOOST_AUTO_TEST_CASE(MergeClosesAfterEveryInput)
+{
+  queue<int> a;
+  queue<int> b;
+  std::vector<int> output;
+
+  thread_pool pool{4};
+
+  auto exec = (merge(from(a), from(b)) | output).run(pool);
+
+  a.push(1);
+  a.close();
+  b.push(2);
+
+  BOOST_CHECK( ! exec.is_done());
+
+  b.push(3);
+  b.close();
+
+  exec.wait();
+
+  std::sort(output.begin(), output.end());
+  BOOST_CHECK(output == std::vector<int>({1, 2, 3}));
+}
+
+BOOST_AUTO_TEST_CASE(MergeNested)
+{
+  std::vector<int> a{1};
+  std::vector<int> b{2};
+  std::vector<int> c{3};
+  std::vector<int> output;
+
+  segment<terminated, int> ab = merge(from(a), from(b));
+
+  thread_pool pool{6};
+
+  auto exec = (merge(ab, from(c)) | output).run(pool);
+  exec.wait();
+
+  std::sort(output.begin(), output.end());
+  BOOST_CHECK(output == std::vector<int>({1, 2, 3}));
+}
+
+BOOST_AUTO_TEST_CASE(Zip)
+{
+  std::vector<int> features(1000);
+  std::iota(features.begin(), features.end(), 0);
+
+  std::vector<int> labels(features);
+
+  std::vector<std::pair<int, int>> output;
+
+  thread_pool pool{6};
+
+  auto exec = (zip(from(features), from(labels) | negate) | output).run(pool);
+  exec.wait();
+
+  BOOST_REQUIRE_EQUAL(output.size(), features.size());
+
+  for (std::size_t i = 0; i < output.size(); ++i)
+  {
+    BOOST_CHECK_EQUAL(output[i].first, features[i]);
+    BOOST_CHECK_EQUAL(output[i].second, -features[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ZipShorterInput)
+{
+  std::vector<int> first{1, 2, 3, 4, 5};
+  std::vector<char> second{'a', 'b', 'c'};
+
+  std::vector<std::pair<int, char>> output;
+
+  thread_pool pool{4};
+
+  auto exec = (zip(from(first), from(second)) | output).run(pool);
+  exec.wait();
+
+  BOOST_REQUIRE_EQUAL(output.size(), 3u);
+  BOOST_CHECK(output[2] == std::make_pair(3, 'c'));
+}
@@ -0,0 +1,137 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#include <vector>
+#include <string>
+#include <numeric>
+#include <thread>
+#include <chrono>
+
+#include <boost/pipeline.hpp>
+
+#define BOOST_TEST_MODULE FanOut
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::pipeline;
+
+int twice(int i) { return 2 * i; }
+
+BOOST_AUTO_TEST_CASE(Tee)
+{
+  std::vector<int> input(5000);
+  std::iota(input.begin(), input.end(), 0);
+
+  std::vector<int> out_a;
+  std::vector<int> out_b;
+  std::vector<int> out_c;
+
+  segment<int, terminated> branch_c = make(twice) | out_c;
+
+  thread_pool pool{10};
+
+  auto exec = (from(input) | tee(make(out_a), make(twice) | out_b, branch_c)).run(pool);
+  exec.wait();
+
+  BOOST_CHECK(exec.is_done());
+  BOOST_CHECK(out_a == input);
+
+  BOOST_REQUIRE_EQUAL(out_b.size(), input.size());
+  BOOST_CHECK(out_b == out_c);
+  BOOST_CHECK_EQUAL(out_b.back(), 2 * 4999);
+}
+
+BOOST_AUTO_TEST_CASE(TeeSlowBranch)
+{
+  std::vector<std::string> input(3000, "item");
+
+  std::size_t fast_count = 0;
+  std::size_t slow_count = 0;
+
+  auto fast = [&fast_count](const std::string&) { ++fast_count; };
+  auto slow = [&slow_count](const std::string&)
+  {
+    if (slow_count % 500 == 0)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    ++slow_count;
+  };
+
+  thread_pool pool{8};
+
+  auto exec = (from(input) | tee(make(fast), make(slow))).run(pool);
+  exec.wait();
+
+  BOOST_CHECK_EQUAL(fast_count, input.size());
+  BOOST_CHECK_EQUAL(slow_count, input.size());
+}
+
+BOOST_AUTO_TEST_CASE(TeeTypeErased)
+{
+  std::vector<int> input{1, 2, 3};
+  std::vector<int> out_a;
+  std::vector<int> out_b;
+
+  segment<int, terminated> t = make(twice) | tee(make(out_a), make(out_b));
+  segment<terminated, int> source = from(input);
+
+  plan p = source | t;
+
+  thread_pool pool{8};
+
+  auto exec = p.run(pool);
+  exec.wait();
+
+  BOOST_CHECK(out_a == std::vector<int>({2, 4, 6}));
+  BOOST_CHECK(out_a == out_b);
+}
+
+BOOST_AUTO_TEST_CASE(Route)
+{
+  std::vector<int> input(1000);
+  std::iota(input.begin(), input.end(), 0);
+
+  std::vector<int> out_0;
+  std::vector<int> out_1;
+  std::vector<int> out_2;
+
+  auto mod_3 = [](int i) -> std::size_t { return i % 3; };
+
+  thread_pool pool{8};
+
+  auto exec = (from(input) | route(mod_3, make(out_0), make(out_1), make(twice) | out_2)).run(pool);
+  exec.wait();
+
+  BOOST_CHECK_EQUAL(out_0.size() + out_1.size() + out_2.size(), input.size());
+
+  for (std::size_t i = 0; i < out_0.size(); ++i) { BOOST_CHECK_EQUAL(out_0[i], 3 * i); }
+  for (std::size_t i = 0; i < out_1.size(); ++i) { BOOST_CHECK_EQUAL(out_1[i], 3 * i + 1); }
+  for (std::size_t i = 0; i < out_2.size(); ++i) { BOOST_CHECK_EQUAL(out_2[i], 2 * (3 * i + 2)); }
+}
+
+BOOST_AUTO_TEST_CASE(RouteEmptyBranch)
+{
+  std::vector<int> input{1, 2, 3};
+  std::vector<int> out_0;
+  std::vector<int> out_1;
+
+  auto first = [](int) -> std::size_t { return 0; };
+
+  thread_pool pool{6};
+
+  auto exec = (from(input) | route(first, make(out_0), make(out_1))).run(pool);
+  exec.wait();
+
+  BOOST_CHECK(out_0 == input);
+  BOOST_CHECK(out_1.empty());
+}
@@ -0,0 +1,189 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <boost/pipeline.hpp>
+
+#define BOOST_TEST_MODULE File
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::pipeline;
+
+/** Temporary file, removed on destruction */
+struct temp_file
+{
+  explicit temp_file(const std::string& content)
+  {
+    char name[] = "/tmp/pipeline_file_test_XXXXXX";
+    const int fd = mkstemp(name);
+    BOOST_REQUIRE(fd >= 0);
+    BOOST_REQUIRE(write(fd, content.data(), content.size()) == ssize_t(content.size()));
+    close(fd);
+    path = name;
+  }
+
+  ~temp_file() { std::remove(path.c_str()); }
+
+  std::string path;
+};
+
+std::string content_of(const std::string& path)
+{
+  std::ifstream file(path);
+  std::ostringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+std::vector<std::string> lines_of(const std::string& content)
+{
+  temp_file file(content);
+  mapped_file mapping(file.path);
+
+  std::vector<std::string> output;
+
+  thread_pool pool{2};
+
+  auto to_string = [](const boost::string_ref& line) { return line.to_string(); };
+  auto exec = (from_file_lines(mapping) | to_string | output).run(pool);
+  exec.wait();
+
+  return output;
+}
+
+BOOST_AUTO_TEST_CASE(LineIterator)
+{
+  const std::string content = "first\n\nthird";
+  detail::line_iterator it(content.data(), content.data() + content.size());
+  detail::line_iterator end(content.data() + content.size(), content.data() + content.size());
+
+  BOOST_REQUIRE(it != end);
+  BOOST_CHECK_EQUAL(*it, "first");
+  BOOST_REQUIRE(++it != end);
+  BOOST_CHECK_EQUAL(*it, "");
+  BOOST_REQUIRE(++it != end);
+  BOOST_CHECK_EQUAL(*it, "third");
+  BOOST_CHECK(++it == end);
+}
+
+BOOST_AUTO_TEST_CASE(FromFileLines)
+{
+  std::vector<std::string> expected{"alpha", "beta", "", "gamma"};
+
+  auto output = lines_of("alpha\nbeta\n\ngamma\n");
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+
+  // no trailing newline
+  output = lines_of("alpha\nbeta\n\ngamma");
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+
+  BOOST_CHECK(lines_of("").empty());
+}
+
+BOOST_AUTO_TEST_CASE(MissingFile)
+{
+  BOOST_CHECK_THROW(mapped_file("/nonexistent/pipeline_file_test"), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(ToFile)
+{
+  temp_file file("");
+
+  std::vector<int> input;
+  std::string expected;
+  for (int i = 0; i < 1000; ++i)
+  {
+    input.push_back(i);
+    expected += std::to_string(i) + "\n";
+  }
+
+  thread_pool pool{2};
+
+  // small buffers: several writes are issued
+  auto exec = (from(input) | to_file(file.path, line_format(), 64, sync_policy::on_flush)).run(pool);
+  exec.wait();
+
+  BOOST_CHECK_EQUAL(content_of(file.path), expected);
+}
+
+BOOST_AUTO_TEST_CASE(ToFd)
+{
+  temp_file file("");
+  const int fd = open(file.path.c_str(), O_WRONLY | O_APPEND);
+  BOOST_REQUIRE(fd >= 0);
+
+  std::vector<std::string> input{"first", "second"};
+
+  auto quoted = [](const std::string& item, std::string& buffer)
+  {
+    buffer += "'" + item + "' ";
+  };
+
+  thread_pool pool{2};
+
+  auto exec = (from(input) | to_fd(fd, quoted)).run(pool);
+  exec.wait();
+
+  // not closed by the sink
+  BOOST_CHECK(write(fd, "!", 1) == 1);
+  close(fd);
+
+  BOOST_CHECK_EQUAL(content_of(file.path), "'first' 'second' !");
+}
+
+BOOST_AUTO_TEST_CASE(ToFileInvalidPath)
+{
+  BOOST_CHECK_THROW(to_file("/nonexistent/pipeline_file_test"), std::runtime_error);
+}
+
+void naturals(queue_back<int>& downstream)
+{
+  for (int i = 0; ! downstream.is_cancelled(); ++i)
+  {
+    downstream.push(i);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ToFdWriteError)
+{
+  temp_file file("");
+
+  // writes fail with EBADF
+  const int fd = open(file.path.c_str(), O_RDONLY);
+  BOOST_REQUIRE(fd >= 0);
+
+  thread_pool pool{2};
+
+  // the failing sink cancels the otherwise endless upstream
+  auto exec = (from(naturals) | to_fd(fd, line_format(), 64)).run(pool);
+
+  BOOST_CHECK_THROW(exec.wait(), std::runtime_error);
+  BOOST_CHECK(exec.is_done());
+
+  close(fd);
+}
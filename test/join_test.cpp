@@ -0,0 +1,184 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+
+#include <boost/pipeline.hpp>
+
+#define BOOST_TEST_MODULE Join
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::pipeline;
+
+typedef std::pair<int, std::string> department; // id, name
+typedef std::pair<std::string, int> person;     // name, department id
+
+int department_id(const department& d) { return d.first; }
+int person_department_id(const person& p) { return p.second; }
+
+std::string relation(const department& d, const person& p)
+{
+  return p.first + "@" + d.second;
+}
+
+BOOST_AUTO_TEST_CASE(HashJoin)
+{
+  std::vector<department> departments{{2, "HR"}, {0, "Board"}, {1, "IT"}, {3, "Legal"}};
+  std::vector<person> persons{
+    {"Jayna", 0}, {"Jenci", 1}, {"Nita", 2}, {"Niamh", 0},
+    {"Hector", 1}, {"Nobody", 7}, {"Agathe", 1}
+  };
+
+  std::vector<std::string> output;
+
+  thread_pool pool{4};
+
+  auto exec = (from(persons)
+    | hash_join(from(departments), department_id, person_department_id, relation)
+    | output
+  ).run(pool);
+  exec.wait();
+
+  std::vector<std::string> expected{
+    "Jayna@Board", "Jenci@IT", "Nita@HR", "Niamh@Board", "Hector@IT", "Agathe@IT"
+  };
+
+  BOOST_CHECK(output == expected);
+}
+
+BOOST_AUTO_TEST_CASE(HashJoinManyToMany)
+{
+  std::vector<int> build;
+  std::vector<int> probe;
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    build.push_back(i % 10);
+    probe.push_back(i % 20);
+  }
+
+  std::vector<std::pair<int, int>> output;
+
+  auto key = [](int i) { return i; };
+  auto combine = [](int b, int p) { return std::make_pair(b, p); };
+
+  thread_pool pool{4};
+
+  auto exec = (from(probe) | hash_join(from(build), key, key, combine) | output).run(pool);
+  exec.wait();
+
+  // 500 probes have a key below 10, each matching 100 build items
+  BOOST_CHECK_EQUAL(output.size(), 500u * 100u);
+  BOOST_CHECK(std::all_of(output.begin(), output.end(),
+    [](const std::pair<int, int>& r) { return r.first == r.second; }
+  ));
+}
+
+BOOST_AUTO_TEST_CASE(HashJoinStreamingProbe)
+{
+  std::vector<department> departments{{0, "Board"}, {1, "IT"}};
+  queue<person> persons;
+  std::vector<std::string> output;
+
+  thread_pool pool{4};
+
+  auto exec = (persons
+    | hash_join(from(departments), department_id, person_department_id, relation)
+    | output
+  ).run(pool);
+
+  persons.push(person("Jenci", 1));
+  persons.push(person("Jayna", 0));
+  persons.close();
+
+  exec.wait();
+
+  BOOST_CHECK(output == std::vector<std::string>({"Jenci@IT", "Jayna@Board"}));
+}
+
+BOOST_AUTO_TEST_CASE(MergeJoin)
+{
+  std::vector<department> departments{{0, "Board"}, {1, "IT"}, {2, "HR"}, {3, "Legal"}, {5, "QA"}};
+  std::vector<person> persons{
+    {"Jayna", 0}, {"Niamh", 0}, {"Jenci", 1}, {"Hector", 1},
+    {"Agathe", 1}, {"Nita", 2}, {"Nobody", 4}, {"Loraine", 5}
+  };
+
+  std::vector<std::string> output;
+
+  thread_pool pool{4};
+
+  auto exec = (from(persons)
+    | merge_join(from(departments), department_id, person_department_id, relation)
+    | output
+  ).run(pool);
+  exec.wait();
+
+  std::vector<std::string> expected{
+    "Jayna@Board", "Niamh@Board", "Jenci@IT", "Hector@IT", "Agathe@IT", "Nita@HR", "Loraine@QA"
+  };
+
+  BOOST_CHECK(output == expected);
+}
+
+BOOST_AUTO_TEST_CASE(MergeJoinManyToMany)
+{
+  std::vector<int> side{1, 1, 2, 3, 3, 3, 7};
+  std::vector<int> input{0, 1, 1, 3, 3, 6, 7, 7, 8};
+
+  std::vector<std::pair<int, int>> output;
+
+  auto key = [](int i) { return i; };
+  auto combine = [](int s, int i) { return std::make_pair(s, i); };
+
+  thread_pool pool{4};
+
+  auto exec = (from(input) | merge_join(from(side), key, key, combine) | output).run(pool);
+  exec.wait();
+
+  // 1: 2x2, 3: 3x2, 7: 1x2
+  BOOST_CHECK_EQUAL(output.size(), 4u + 6u + 2u);
+  BOOST_CHECK(std::all_of(output.begin(), output.end(),
+    [](const std::pair<int, int>& r) { return r.first == r.second; }
+  ));
+  BOOST_CHECK(std::is_sorted(output.begin(), output.end()));
+}
+
+BOOST_AUTO_TEST_CASE(MergeJoinLongInput)
+{
+  std::vector<int> side;
+  std::vector<int> input;
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    side.push_back(i * 2);
+    input.push_back(i);
+    input.push_back(i);
+  }
+
+  std::vector<int> output;
+
+  auto key = [](int i) { return i; };
+  auto combine = [](int, int i) { return i; };
+
+  thread_pool pool{4};
+
+  auto exec = (from(input) | merge_join(from(side), key, key, combine) | output).run(pool);
+  exec.wait();
+
+  BOOST_REQUIRE_EQUAL(output.size(), 1000u);
+  BOOST_CHECK_EQUAL(output.front(), 0);
+  BOOST_CHECK_EQUAL(output.back(), 998);
+}
@@ -11,6 +11,7 @@
  */
 
 #include <vector>
+#include <stdexcept>
 
 #include <boost/pipeline.hpp>
 
@@ -76,3 +77,22 @@ BOOST_AUTO_TEST_CASE(ToFunction)
   exec3.wait();
   exec4.wait();
 }
+
+int fail_on_three(int i)
+{
+  if (i == 3) { throw std::runtime_error("three"); }
+  return i;
+}
+
+BOOST_AUTO_TEST_CASE(TransformationError)
+{
+  std::vector<int> input{0, 1, 2, 3, 4, 5};
+  std::vector<int> output;
+
+  thread_pool pool(4);
+
+  auto exec = (from(input) | fail_on_three | [](int i) { return i; } | output).run(pool);
+
+  BOOST_CHECK_THROW(exec.wait(), std::runtime_error);
+  BOOST_CHECK_EQUAL(output.size(), 3u);
+}
@@ -0,0 +1,99 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cstddef>
+
+#include <boost/pipeline.hpp>
+
+#define BOOST_TEST_MODULE Priority
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::pipeline;
+
+std::size_t urgency(int i) { return (i % 10 == 0) ? 0 : 1; }
+
+BOOST_AUTO_TEST_CASE(PriorityLanes)
+{
+  detail::priority_lanes<int> lanes(2, 2);
+
+  lanes.put(1, 1);
+  lanes.put(1, 2);
+  lanes.put(0, 10);
+  lanes.put(0, 20);
+  lanes.put(0, 30);
+  lanes.put(5, 3); // clamped to lane 1
+
+  BOOST_CHECK_EQUAL(lanes.size(), 6u);
+
+  // lane 1 is served after being passed over twice
+  std::vector<int> popped;
+  while (! lanes.empty()) { popped.push_back(lanes.pop()); }
+
+  std::vector<int> expected{10, 20, 1, 30, 2, 3};
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    popped.begin(), popped.end(),
+    expected.begin(), expected.end()
+  );
+}
+
+BOOST_AUTO_TEST_CASE(PriorityLanesStrict)
+{
+  detail::priority_lanes<int> lanes(2, 0);
+
+  lanes.put(1, 1);
+  lanes.put(0, 10);
+  lanes.put(1, 2);
+  lanes.put(0, 20);
+
+  // no starvation bound: lane 1 is served only if lane 0 is empty
+  std::vector<int> popped;
+  while (! lanes.empty()) { popped.push_back(lanes.pop()); }
+
+  std::vector<int> expected{10, 20, 1, 2};
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    popped.begin(), popped.end(),
+    expected.begin(), expected.end()
+  );
+}
+
+BOOST_AUTO_TEST_CASE(Prioritize)
+{
+  std::vector<int> input;
+  for (int i = 0; i < 200; ++i) { input.push_back(i); }
+
+  auto slow_process = [](int i)
+  {
+    std::this_thread::sleep_for(std::chrono::microseconds(500));
+    return i;
+  };
+
+  std::vector<int> output;
+
+  thread_pool pool{4};
+
+  auto exec = (from(input) | prioritize(urgency, 2, 1000) | slow_process | output).run(pool);
+  exec.wait();
+
+  BOOST_REQUIRE_EQUAL(output.size(), input.size());
+
+  // urgent items overtake most of the bulk items
+  std::size_t last_urgent = 0;
+  for (std::size_t i = 0; i < output.size(); ++i)
+  {
+    if (urgency(output[i]) == 0) { last_urgent = i; }
+  }
+
+  BOOST_CHECK(last_urgent < output.size() / 2);
+}
@@ -11,6 +11,7 @@
  */
 
 #include <memory>
+#include <thread>
 
 #include <boost/pipeline/queue.hpp>
 
@@ -79,3 +80,68 @@ BOOST_AUTO_TEST_CASE(MovableT)
 
   BOOST_CHECK(ret == expected_ret);
 }
+
+BOOST_AUTO_TEST_CASE(SplitQueueBack)
+{
+  queue<int> q;
+  queue_front<int> qf(q);
+  queue_back<int>  qb(q);
+
+  auto producers = qb.split(2);
+
+  producers[0].push(1);
+  producers[0].close();
+
+  BOOST_CHECK(qf.is_closed() == false);
+
+  producers[1].push(2);
+  producers[1].close();
+
+  BOOST_CHECK(qf.is_closed());
+  BOOST_CHECK_EQUAL(qb.size(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(CancelQueue)
+{
+  queue<int> q;
+  queue_front<int> qf(q);
+  queue_back<int>  qb(q);
+
+  qb.push(1);
+  BOOST_CHECK(qb.is_cancelled() == false);
+
+  // does not wait for the producers
+  qf.cancel();
+
+  BOOST_CHECK(qb.is_cancelled());
+  BOOST_CHECK(qf.is_empty());
+  BOOST_CHECK(qf.is_closed() == false);
+
+  // further items are discarded
+  qb.push(2);
+  BOOST_CHECK(qf.is_empty());
+
+  std::thread producer([&qb]()
+  {
+    while (! qb.is_cancelled()) { qb.push(3); }
+    qb.close();
+  });
+
+  producer.join();
+
+  BOOST_CHECK(qf.is_closed());
+  BOOST_CHECK(qf.is_empty());
+}
+
+BOOST_AUTO_TEST_CASE(SharedQueueBack)
+{
+  auto q = std::make_shared<queue<int>>();
+  queue_back<int> qb(q);
+
+  // the consumer terminates first
+  q.reset();
+
+  qb.push(1);
+  BOOST_CHECK_EQUAL(qb.size(), 1u);
+  qb.close();
+}
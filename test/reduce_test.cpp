@@ -0,0 +1,185 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+#include <boost/pipeline.hpp>
+
+#define BOOST_TEST_MODULE Reduce
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::pipeline;
+
+typedef std::pair<int, int> key_count;
+
+int get_key(const key_count& item) { return item.first; }
+
+key_count add(const key_count& a, const key_count& b)
+{
+  return key_count(a.first, a.second + b.second);
+}
+
+key_count to_key_count(int i) { return key_count(i % 10, 1); }
+
+BOOST_AUTO_TEST_CASE(ReduceByKey)
+{
+  std::vector<int> input(10000);
+  for (int i = 0; i < 10000; ++i) { input[i] = i; }
+
+  std::vector<key_count> output;
+
+  thread_pool pool{4};
+
+  auto exec = (from(input) | to_key_count | reduce_by_key(get_key, add) | output).run(pool);
+  exec.wait();
+
+  std::sort(output.begin(), output.end());
+
+  BOOST_REQUIRE_EQUAL(output.size(), 10u);
+
+  for (int i = 0; i < 10; ++i)
+  {
+    BOOST_CHECK_EQUAL(output[i].first, i);
+    BOOST_CHECK_EQUAL(output[i].second, 1000);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ReduceByKeyWorkers)
+{
+  std::vector<int> input(100000);
+  for (int i = 0; i < 100000; ++i) { input[i] = i; }
+
+  std::vector<key_count> output;
+
+  thread_pool pool{8};
+
+  auto exec = (
+      from(input)
+    | to_key_count
+    | reduce_by_key(get_key, add, 4, 4)
+    | output
+  ).run(pool);
+
+  exec.wait();
+
+  std::sort(output.begin(), output.end());
+
+  BOOST_REQUIRE_EQUAL(output.size(), 10u);
+
+  for (int i = 0; i < 10; ++i)
+  {
+    BOOST_CHECK_EQUAL(output[i].first, i);
+    BOOST_CHECK_EQUAL(output[i].second, 10000);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ReduceByKeyFlushPartials)
+{
+  std::vector<std::string> input{"a", "b", "c", "a", "b", "a", "d", "e", "a"};
+
+  std::vector<std::string> output;
+
+  thread_pool pool{5};
+
+  auto exec = (
+      from(input)
+    | reduce_by_key(
+        [](const std::string& s) { return s[0]; },
+        [](const std::string& a, const std::string& b) { return a + b; },
+        2, 2
+      )
+    | output
+  ).run(pool);
+
+  exec.wait();
+
+  std::sort(output.begin(), output.end());
+
+  std::vector<std::string> expected{"aaaa", "bb", "c", "d", "e"};
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+}
+
+BOOST_AUTO_TEST_CASE(ReduceByKeyEmpty)
+{
+  std::vector<key_count> input;
+  std::vector<key_count> output;
+
+  thread_pool pool{4};
+
+  auto exec = (from(input) | reduce_by_key(get_key, add) | output).run(pool);
+  exec.wait();
+
+  BOOST_CHECK(output.empty());
+}
+
+BOOST_AUTO_TEST_CASE(TopK)
+{
+  std::vector<int> input{5, 1, 9, 3, 7, 9, 2, 8};
+  std::vector<int> output;
+
+  thread_pool pool{2};
+
+  auto exec = (from(input) | top_k(3, std::less<int>()) | output).run(pool);
+  exec.wait();
+
+  std::vector<int> expected{9, 9, 8};
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+}
+
+BOOST_AUTO_TEST_CASE(TopKShortInput)
+{
+  std::vector<int> input{2, 3, 1};
+  std::vector<int> output;
+
+  thread_pool pool{2};
+
+  auto exec = (from(input) | top_k(10, std::greater<int>()) | output).run(pool);
+  exec.wait();
+
+  std::vector<int> expected{1, 2, 3};
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+}
+
+BOOST_AUTO_TEST_CASE(TopKMerged)
+{
+  std::vector<int> a;
+  std::vector<int> b;
+
+  for (int i = 0; i < 1000; ++i) { ((i % 2) ? a : b).push_back((i * 7919) % 1000); }
+
+  std::vector<int> output;
+
+  thread_pool pool{4};
+
+  auto top_5 = top_k(5, std::less<int>());
+  auto exec = (merge(from(a) | top_5, from(b) | top_5) | top_5 | output).run(pool);
+  exec.wait();
+
+  std::vector<int> expected{999, 998, 997, 996, 995};
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+}
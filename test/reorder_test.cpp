@@ -0,0 +1,113 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#include <vector>
+#include <cstdint>
+
+#include <boost/pipeline.hpp>
+
+#define BOOST_TEST_MODULE Reorder
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::pipeline;
+
+std::uint64_t seq_of(int i) { return static_cast<std::uint64_t>(i); }
+
+int missing(std::uint64_t) { return -1; }
+
+std::vector<int> run_reorder(
+  const std::vector<int>& input,
+  std::size_t window,
+  std::uint64_t start = 0
+)
+{
+  std::vector<int> output;
+
+  thread_pool pool{2};
+  auto exec = (from(input) | reorder(seq_of, window, start) | output).run(pool);
+  exec.wait();
+
+  return output;
+}
+
+BOOST_AUTO_TEST_CASE(ReorderInWindow)
+{
+  std::vector<int> input{10, 12, 11, 14, 13, 15, 17, 16};
+  std::vector<int> output = run_reorder(input, 4, 10);
+
+  std::vector<int> expected{10, 11, 12, 13, 14, 15, 16, 17};
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+}
+
+BOOST_AUTO_TEST_CASE(ReorderFirstArrivesLate)
+{
+  std::vector<int> input{1, 0, 2, 3};
+  std::vector<int> output = run_reorder(input, 4);
+
+  std::vector<int> expected{0, 1, 2, 3};
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+}
+
+BOOST_AUTO_TEST_CASE(ReorderEmptyWindowClamped)
+{
+  std::vector<int> input{0, 2, 1, 3};
+  std::vector<int> output;
+
+  thread_pool pool{2};
+
+  // the factory asserts on an empty window
+  typedef detail::reorder_stage<std::uint64_t(*)(int), detail::skip_gaps> stage;
+  auto exec = (from(input) | stage(seq_of, 0, 0, detail::skip_gaps()) | output).run(pool);
+  exec.wait();
+
+  // a single slot: 1 is late after 2 forced skipping it
+  std::vector<int> expected{0, 2, 3};
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+}
+
+BOOST_AUTO_TEST_CASE(ReorderSkipGaps)
+{
+  // 2 is lost, 1 and 3 are duplicated, 0 arrives too late
+  std::vector<int> input{1, 3, 1, 4, 5, 6, 0, 3, 8, 100};
+  std::vector<int> output = run_reorder(input, 4);
+
+  std::vector<int> expected{1, 3, 4, 5, 6, 8, 100};
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+}
+
+BOOST_AUTO_TEST_CASE(ReorderFillGaps)
+{
+  std::vector<int> input{0, 3, 2, 5, 7};
+  std::vector<int> output;
+
+  thread_pool pool{2};
+  auto exec = (from(input) | reorder(seq_of, 2, missing) | output).run(pool);
+  exec.wait();
+
+  std::vector<int> expected{0, -1, 2, 3, -1, 5, -1, 7};
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+}
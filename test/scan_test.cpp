@@ -0,0 +1,91 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#include <vector>
+#include <string>
+#include <numeric>
+#include <functional>
+
+#include <boost/pipeline.hpp>
+
+#define BOOST_TEST_MODULE Scan
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::pipeline;
+
+BOOST_AUTO_TEST_CASE(Scan)
+{
+  std::vector<int> input{1, 2, 3, 4, 5};
+  std::vector<long> output;
+
+  thread_pool pool{2};
+
+  auto exec = (from(input) | scan(10L, [](long acc, int i) { return acc + i; }) | output).run(pool);
+  exec.wait();
+
+  std::vector<long> expected{11, 13, 16, 20, 25};
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+}
+
+BOOST_AUTO_TEST_CASE(ScanDifferentType)
+{
+  std::vector<char> input{'a', 'b', 'c'};
+  std::vector<std::string> output;
+
+  thread_pool pool{2};
+
+  auto exec = (
+      from(input)
+    | scan(std::string(), [](const std::string& acc, char c) { return acc + c; })
+    | output
+  ).run(pool);
+
+  exec.wait();
+
+  std::vector<std::string> expected{"a", "ab", "abc"};
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+}
+
+BOOST_AUTO_TEST_CASE(ParallelScan)
+{
+  std::vector<long> input(100000);
+  std::iota(input.begin(), input.end(), 0);
+
+  std::vector<long> output;
+
+  thread_pool pool{4};
+
+  auto exec = (
+      from(input)
+    | batch(30000)
+    | parallel_scan(5, std::plus<long>(), 4)
+    | unbatch()
+    | output
+  ).run(pool);
+
+  exec.wait();
+
+  std::vector<long> expected(input.size());
+  std::partial_sum(input.begin(), input.end(), expected.begin());
+  for (long& e : expected) { e += 5; }
+
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+}
@@ -0,0 +1,106 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#include <vector>
+#include <chrono>
+#include <utility>
+
+#include <boost/pipeline.hpp>
+
+#define BOOST_TEST_MODULE Shed
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::pipeline;
+
+typedef std::chrono::steady_clock::time_point timestamp;
+typedef std::pair<int, timestamp> event; // id, creation time
+
+timestamp created_at(const event& e) { return e.second; }
+
+void naturals(queue_back<int>& downstream)
+{
+  for (int i = 0; ! downstream.is_cancelled(); ++i)
+  {
+    downstream.push(i);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Policies)
+{
+  auto depth = max_depth(10);
+
+  BOOST_CHECK(depth(1, 9) == false);
+  BOOST_CHECK(depth(1, 10));
+
+  auto age = max_age(std::chrono::seconds(60), created_at);
+  const auto now = std::chrono::steady_clock::now();
+
+  BOOST_CHECK(age(event(1, now), 0) == false);
+  BOOST_CHECK(age(event(2, now - std::chrono::hours(1)), 0));
+}
+
+BOOST_AUTO_TEST_CASE(ShedByAge)
+{
+  const auto now = std::chrono::steady_clock::now();
+  const auto stale = now - std::chrono::hours(1);
+
+  std::vector<event> input{{0, now}, {1, stale}, {2, now}, {3, stale}, {4, stale}};
+  std::vector<event> output;
+
+  thread_pool pool{2};
+
+  auto shedder = shed(max_age(std::chrono::minutes(10), created_at));
+  auto exec = (from(input) | shedder | output).run(pool);
+  exec.wait();
+
+  BOOST_REQUIRE_EQUAL(output.size(), 2u);
+  BOOST_CHECK_EQUAL(output[0].first, 0);
+  BOOST_CHECK_EQUAL(output[1].first, 2);
+
+  BOOST_CHECK_EQUAL(shedder.passed(), 2u);
+  BOOST_CHECK_EQUAL(shedder.dropped(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(ShedSample)
+{
+  std::vector<int> input;
+  for (int i = 0; i < 30; ++i) { input.push_back(i); }
+
+  std::vector<int> output;
+
+  thread_pool pool{2};
+
+  // always overloaded: every third item is passed
+  auto shedder = shed(max_depth(0), 3);
+  auto exec = (from(input) | shedder | output).run(pool);
+  exec.wait();
+
+  BOOST_REQUIRE_EQUAL(output.size(), 10u);
+  BOOST_CHECK_EQUAL(output[0], 2);
+  BOOST_CHECK_EQUAL(output[9], 29);
+
+  BOOST_CHECK_EQUAL(shedder.passed(), 10u);
+  BOOST_CHECK_EQUAL(shedder.dropped(), 20u);
+}
+
+BOOST_AUTO_TEST_CASE(ShedCancelledByTake)
+{
+  std::vector<int> output;
+
+  thread_pool pool{4};
+
+  // would never terminate without cancellation
+  auto exec = (from(naturals) | shed(max_depth(1000000)) | take(5) | output).run(pool);
+  exec.wait();
+
+  BOOST_CHECK_EQUAL(output.size(), 5u);
+}
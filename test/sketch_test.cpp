@@ -0,0 +1,144 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include <boost/pipeline.hpp>
+
+#define BOOST_TEST_MODULE Sketch
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::pipeline;
+
+std::vector<int> repeated(int distinct, int times)
+{
+  std::vector<int> result;
+  for (int t = 0; t < times; ++t)
+  {
+    for (int i = 0; i < distinct; ++i) { result.push_back(i); }
+  }
+
+  return result;
+}
+
+BOOST_AUTO_TEST_CASE(HyperLogLog)
+{
+  std::vector<int> input = repeated(100000, 3);
+
+  thread_pool pool{2};
+
+  auto exec = (from(input) | to_hll()).run(pool);
+
+  BOOST_CHECK_CLOSE(exec.get().estimate(), 100000.0, 5);
+}
+
+BOOST_AUTO_TEST_CASE(HyperLogLogSmall)
+{
+  hyperloglog hll;
+  for (int i = 0; i < 100; ++i) { hll.add(i % 10); }
+
+  BOOST_CHECK_CLOSE(hll.estimate(), 10.0, 5);
+}
+
+BOOST_AUTO_TEST_CASE(HyperLogLogPrecisionRange)
+{
+  hyperloglog coarse(4);
+  hyperloglog fine(18);
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    coarse.add(i);
+    fine.add(i);
+  }
+
+  // standard errors of 26% and 0.2%
+  BOOST_CHECK_CLOSE(coarse.estimate(), 1000.0, 80);
+  BOOST_CHECK_CLOSE(fine.estimate(), 1000.0, 2);
+}
+
+BOOST_AUTO_TEST_CASE(HyperLogLogMerge)
+{
+  std::vector<int> a = repeated(60000, 1);
+  std::vector<int> b;
+  for (int i = 30000; i < 90000; ++i) { b.push_back(i); }
+
+  thread_pool pool{4};
+
+  auto exec_a = (from(a) | to_hll()).run(pool);
+  auto exec_b = (from(b) | to_hll()).run(pool);
+
+  hyperloglog& merged = exec_a.get();
+  merged.merge(exec_b.get());
+
+  BOOST_CHECK_CLOSE(merged.estimate(), 90000.0, 5);
+}
+
+BOOST_AUTO_TEST_CASE(CountMin)
+{
+  std::vector<std::string> input;
+  for (int i = 0; i < 10000; ++i)
+  {
+    input.push_back((i % 10 == 0) ? "hot" : std::to_string(i));
+  }
+
+  thread_pool pool{2};
+
+  auto exec = (from(input) | to_count_min()).run(pool);
+  count_min_sketch& sketch = exec.get();
+
+  BOOST_CHECK_EQUAL(sketch.total(), 10000u);
+  BOOST_CHECK_GE(sketch.estimate(std::string("hot")), 1000u);
+  BOOST_CHECK_LE(sketch.estimate(std::string("hot")), 1020u);
+  BOOST_CHECK_LE(sketch.estimate(std::string("cold")), 20u);
+
+  count_min_sketch other;
+  other.add(std::string("hot"), 5);
+  sketch.merge(other);
+
+  BOOST_CHECK_GE(sketch.estimate(std::string("hot")), 1005u);
+  BOOST_CHECK_EQUAL(sketch.total(), 10005u);
+}
+
+BOOST_AUTO_TEST_CASE(Quantiles)
+{
+  std::vector<double> input;
+  for (int i = 1; i <= 10000; ++i) { input.push_back(i); }
+
+  thread_pool pool{2};
+
+  auto exec = (from(input) | to_quantiles(0.01)).run(pool);
+  quantile_sketch& sketch = exec.get();
+
+  BOOST_CHECK_EQUAL(sketch.count(), 10000u);
+  BOOST_CHECK_CLOSE(sketch.quantile(0.5), 5000.0, 1.1);
+  BOOST_CHECK_CLOSE(sketch.quantile(0.99), 9900.0, 1.1);
+  BOOST_CHECK_CLOSE(sketch.quantile(1), 10000.0, 1.1);
+}
+
+BOOST_AUTO_TEST_CASE(QuantilesMerge)
+{
+  quantile_sketch low;
+  quantile_sketch high;
+
+  low.add(0);
+  for (int i = 1; i <= 500; ++i) { low.add(i); }
+  for (int i = 501; i <= 1000; ++i) { high.add(i); }
+
+  high.merge(low);
+
+  BOOST_CHECK_EQUAL(high.count(), 1001u);
+  BOOST_CHECK_EQUAL(high.quantile(0), 0.0);
+  BOOST_CHECK_CLOSE(high.quantile(0.5), 500.0, 1.1);
+  BOOST_CHECK_CLOSE(high.quantile(0.9), 900.0, 1.1);
+}
@@ -0,0 +1,140 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+#include <functional>
+
+#include <signal.h>
+#include <sys/resource.h>
+
+#include <boost/pipeline.hpp>
+
+#define BOOST_TEST_MODULE Sort
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::pipeline;
+
+std::vector<int> shuffled(int n)
+{
+  std::vector<int> result(n);
+  for (int i = 0; i < n; ++i) { result[i] = i; }
+
+  std::shuffle(result.begin(), result.end(), std::mt19937(42));
+  return result;
+}
+
+BOOST_AUTO_TEST_CASE(SortInMemory)
+{
+  std::vector<int> input = shuffled(1000);
+  std::vector<int> output;
+
+  thread_pool pool{2};
+
+  auto exec = (from(input) | sort(std::greater<int>()) | output).run(pool);
+  exec.wait();
+
+  std::sort(input.begin(), input.end(), std::greater<int>());
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    input.begin(), input.end()
+  );
+}
+
+BOOST_AUTO_TEST_CASE(SortSpill)
+{
+  std::vector<int> input = shuffled(10000);
+  std::vector<int> output;
+
+  thread_pool pool{2};
+
+  // runs of 100 items
+  auto exec = (from(input) | sort(std::less<int>(), 200 * sizeof(int)) | output).run(pool);
+  exec.wait();
+
+  std::sort(input.begin(), input.end());
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    input.begin(), input.end()
+  );
+}
+
+BOOST_AUTO_TEST_CASE(SortSpillStrings)
+{
+  std::vector<std::string> input;
+  for (int i : shuffled(1000)) { input.push_back(std::string(i % 7, 'x') + std::to_string(i)); }
+
+  std::vector<std::string> output;
+
+  thread_pool pool{2};
+
+  auto exec = (
+      from(input)
+    | sort(std::less<std::string>(), 64 * sizeof(std::string))
+    | output
+  ).run(pool);
+
+  exec.wait();
+
+  std::sort(input.begin(), input.end());
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    input.begin(), input.end()
+  );
+}
+
+BOOST_AUTO_TEST_CASE(SortWithoutSpillCodec)
+{
+  typedef std::pair<std::string, int> item;
+
+  std::vector<item> input;
+  for (int i : shuffled(1000)) { input.push_back(item(std::to_string(i % 10), i)); }
+
+  std::vector<item> output;
+
+  thread_pool pool{2};
+
+  // can't be spilled, sorted in memory regardless of the budget
+  auto exec = (from(input) | sort(std::less<item>(), 64 * sizeof(item)) | output).run(pool);
+  exec.wait();
+
+  std::sort(input.begin(), input.end());
+  BOOST_CHECK_EQUAL(output.size(), input.size());
+  BOOST_CHECK(output == input);
+}
+
+BOOST_AUTO_TEST_CASE(SortSpillError)
+{
+  std::vector<int> input = shuffled(10000);
+  std::vector<int> output;
+
+  // files can't grow: spilling fails with EFBIG instead of a signal
+  signal(SIGXFSZ, SIG_IGN);
+  rlimit original;
+  getrlimit(RLIMIT_FSIZE, &original);
+  rlimit limited = original;
+  limited.rlim_cur = 0;
+  setrlimit(RLIMIT_FSIZE, &limited);
+
+  thread_pool pool{2};
+
+  auto exec = (from(input) | sort(std::less<int>(), 200 * sizeof(int)) | output).run(pool);
+  BOOST_CHECK_THROW(exec.wait(), std::runtime_error);
+
+  setrlimit(RLIMIT_FSIZE, &original);
+
+  BOOST_CHECK(output.empty());
+}
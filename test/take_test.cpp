@@ -0,0 +1,193 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#include <vector>
+#include <numeric>
+#include <utility>
+#include <functional>
+
+#include <boost/pipeline.hpp>
+
+#define BOOST_TEST_MODULE Take
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::pipeline;
+
+void naturals(queue_back<int>& downstream)
+{
+  for (int i = 0; ! downstream.is_cancelled(); ++i)
+  {
+    downstream.push(i);
+  }
+}
+
+int twice(int i) { return 2 * i; }
+
+void twice_n(int i, queue_back<int>& downstream)
+{
+  downstream.push(2 * i);
+}
+
+BOOST_AUTO_TEST_CASE(Take)
+{
+  std::vector<int> input(100000);
+  std::iota(input.begin(), input.end(), 0);
+
+  std::vector<int> output;
+
+  thread_pool pool{3};
+
+  auto exec = (from(input) | twice | take(3) | output).run(pool);
+  exec.wait();
+
+  std::vector<int> expected{0, 2, 4};
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+}
+
+BOOST_AUTO_TEST_CASE(TakeCancelsGenerator)
+{
+  std::vector<int> output;
+
+  thread_pool pool{4};
+
+  // would never terminate without cancellation
+  auto exec = (from(naturals) | twice | twice_n | take(5) | output).run(pool);
+  exec.wait();
+
+  std::vector<int> expected{0, 4, 8, 12, 16};
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+}
+
+BOOST_AUTO_TEST_CASE(TakeCancelsWholeStreamStages)
+{
+  std::vector<int> output;
+
+  thread_pool pool{6};
+
+  auto identity = [](int i) { return i; };
+
+  auto exec = (
+      from(naturals)
+    | scan(0, std::plus<int>())
+    | dedupe(identity)
+    | sliding_window(2, 1, std::plus<int>())
+    | take(5)
+    | output
+  ).run(pool);
+
+  exec.wait();
+
+  // 0, 1, 3, 6, 10, 15 summed pairwise
+  std::vector<int> expected{1, 4, 9, 16, 25};
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+}
+
+BOOST_AUTO_TEST_CASE(TakeCancelsZip)
+{
+  std::vector<std::pair<int, int>> output;
+
+  thread_pool pool{4};
+
+  auto exec = (zip(from(naturals), from(naturals)) | take(3) | output).run(pool);
+  exec.wait();
+
+  BOOST_REQUIRE_EQUAL(output.size(), 3u);
+  BOOST_CHECK(output[2] == std::make_pair(2, 2));
+}
+
+BOOST_AUTO_TEST_CASE(TakeCancelsTee)
+{
+  std::vector<int> out_a;
+  std::vector<int> out_b;
+
+  thread_pool pool{8};
+
+  auto exec = (from(naturals) | tee(make(take(3)) | out_a, make(take(5)) | out_b)).run(pool);
+  exec.wait();
+
+  BOOST_CHECK_EQUAL(out_a.size(), 3u);
+  BOOST_CHECK_EQUAL(out_b.size(), 5u);
+}
+
+BOOST_AUTO_TEST_CASE(TakeMoreThanAvailable)
+{
+  std::vector<int> input{1, 2, 3};
+  std::vector<int> output;
+
+  thread_pool pool{2};
+
+  auto exec = (from(input) | take(10) | output).run(pool);
+  exec.wait();
+
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    input.begin(), input.end()
+  );
+}
+
+BOOST_AUTO_TEST_CASE(TakeFromOpenQueue)
+{
+  queue<int> input;
+  std::vector<int> output;
+  std::vector<int> output_while;
+
+  thread_pool pool{8};
+
+  for (int i = 0; i < 10; ++i) { input.push(i); }
+
+  auto exec = (
+      input
+    | tee(
+        make(take(5)) | output,
+        make(take_while([](int i) { return i < 3; })) | output_while
+      )
+  ).run(pool);
+
+  // the source is still open
+  exec.wait();
+
+  BOOST_CHECK_EQUAL(output.size(), 5u);
+  BOOST_CHECK_EQUAL(output_while.size(), 3u);
+
+  input.close();
+}
+
+BOOST_AUTO_TEST_CASE(TakeWhile)
+{
+  std::vector<int> output;
+
+  thread_pool pool{3};
+
+  auto exec = (
+      from(naturals)
+    | take_while([](int i) { return i < 4; })
+    | take(100)
+    | output
+  ).run(pool);
+
+  exec.wait();
+
+  std::vector<int> expected{0, 1, 2, 3};
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    output.begin(), output.end(),
+    expected.begin(), expected.end()
+  );
+}
@@ -0,0 +1,123 @@
+/**
+ * Boost.Pipeline
+ *
+ * Copyright 2014 Benedek Thaler
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See $PIPELINE_WEBSITE$ for documentation
+ */
+
+#include <vector>
+#include <string>
+#include <numeric>
+#include <algorithm>
+#include <functional>
+
+#include <boost/pipeline.hpp>
+
+#define BOOST_TEST_MODULE Window
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::pipeline;
+
+BOOST_AUTO_TEST_CASE(TumblingWindow)
+{
+  std::vector<int> input(10);
+  std::iota(input.begin(), input.end(), 1);
+
+  std::vector<int> output;
+
+  thread_pool pool{3};
+
+  auto exec = (from(input) | tumbling_window(4, std::plus<int>()) | output).run(pool);
+  exec.wait();
+
+  BOOST_CHECK(output == std::vector<int>({1+2+3+4, 5+6+7+8, 9+10}));
+}
+
+BOOST_AUTO_TEST_CASE(SlidingWindowTwoStacks)
+{
+  std::vector<int> input{5, 1, 4, 2, 8, 3, 1, 1, 7, 2};
+  std::vector<int> output;
+
+  auto max = [](int a, int b) { return std::max(a, b); };
+
+  thread_pool pool{3};
+
+  auto exec = (from(input) | sliding_window(3, 2, max) | output).run(pool);
+  exec.wait();
+
+  // windows: [5 1 4] [4 2 8] [8 3 1] [1 1 7]
+  BOOST_CHECK(output == std::vector<int>({5, 8, 8, 7}));
+}
+
+BOOST_AUTO_TEST_CASE(SlidingWindowNonCommutative)
+{
+  std::vector<std::string> input{"a", "b", "c", "d", "e"};
+  std::vector<std::string> output;
+
+  thread_pool pool{3};
+
+  auto exec = (from(input) | sliding_window(3, 1, std::plus<std::string>()) | output).run(pool);
+  exec.wait();
+
+  BOOST_CHECK(output == std::vector<std::string>({"abc", "bcd", "cde"}));
+}
+
+BOOST_AUTO_TEST_CASE(SlidingWindowInvertible)
+{
+  std::vector<int> input(100);
+  std::iota(input.begin(), input.end(), 0);
+
+  std::vector<int> output;
+
+  thread_pool pool{3};
+
+  auto exec = (from(input)
+    | sliding_window(10, 1, std::plus<int>(), std::minus<int>())
+    | output
+  ).run(pool);
+  exec.wait();
+
+  BOOST_REQUIRE_EQUAL(output.size(), 91u);
+
+  for (std::size_t i = 0; i < output.size(); ++i)
+  {
+    auto first = input.begin() + i;
+    BOOST_CHECK_EQUAL(output[i], std::accumulate(first, first + 10, 0));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(SlidingWindowTooFewItems)
+{
+  std::vector<int> input{1, 2};
+  std::vector<int> output;
+
+  thread_pool pool{3};
+
+  auto exec = (from(input) | sliding_window(3, 1, std::plus<int>()) | output).run(pool);
+  exec.wait();
+
+  BOOST_CHECK(output.empty());
+}
+
+BOOST_AUTO_TEST_CASE(SlidingWindowEmptyClamped)
+{
+  std::vector<int> input{1, 2, 3};
+  std::vector<int> output;
+
+  thread_pool pool{3};
+
+  // the factory asserts on an empty window
+  typedef detail::two_stacks_aggregator<std::plus<int>> aggregator;
+  typedef detail::sliding_window_stage<aggregator> stage;
+
+  auto exec = (from(input) | stage(0, 0, aggregator{std::plus<int>()}) | output).run(pool);
+  exec.wait();
+
+  // windows of a single item, after every item
+  BOOST_CHECK(output == input);
+}